@@ -91,6 +91,10 @@
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "net/NetScheduler.h"
+
+#include "modplatform/helpers/HashCache.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include "java/JavaUtils.h"
 
@@ -101,6 +105,7 @@
 #include "tools/MCEditTool.h"
 
 #include "settings/INISettingsObject.h"
+#include "settings/WriteBehindQueue.h"
 #include "settings/Setting.h"
 
 #include "translations/TranslationsModel.h"
@@ -750,6 +755,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
     // initialize network access and proxy setup
     {
         m_network = new QNetworkAccessManager();
+        m_netScheduler.reset(new Net::Scheduler());
         QString proxyTypeStr = settings()->get("ProxyType").toString();
         QString addr = settings()->get("ProxyAddr").toString();
         int port = settings()->get("ProxyPort").value<qint16>();
@@ -871,6 +877,12 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->Load();
+
+        m_hashCache = std::make_shared<Hashing::HashCache>("cache/hashes.dat");
+        m_hashCache->load();
+
+        m_modDetailsCache = std::make_shared<ModDetailsCache>("cache/moddetails.dat", m_hashCache);
+        m_modDetailsCache->load();
         qDebug() << "<> Cache initialized.";
     }
 
@@ -902,6 +914,8 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
+        // and the settings that haven't been written yet
+        WriteBehindQueue::instance().flush();
         if(logFile)
         {
             logFile->flush();
@@ -1554,11 +1568,26 @@ shared_qobject_ptr< HttpMetaCache > Application::metacache()
     return m_metacache;
 }
 
+std::shared_ptr<Hashing::HashCache> Application::hashCache()
+{
+    return m_hashCache;
+}
+
+std::shared_ptr<ModDetailsCache> Application::modDetailsCache()
+{
+    return m_modDetailsCache;
+}
+
 shared_qobject_ptr<QNetworkAccessManager> Application::network()
 {
     return m_network;
 }
 
+shared_qobject_ptr<Net::Scheduler> Application::netScheduler()
+{
+    return m_netScheduler;
+}
+
 shared_qobject_ptr<Meta::Index> Application::metadataIndex()
 {
     if (!m_metadataIndex)
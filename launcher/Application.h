@@ -73,6 +73,16 @@ namespace Meta {
     class Index;
 }
 
+namespace Net {
+    class Scheduler;
+}
+
+namespace Hashing {
+    class HashCache;
+}
+
+class ModDetailsCache;
+
 #if defined(APPLICATION)
 #undef APPLICATION
 #endif
@@ -158,8 +168,14 @@ public:
 
     shared_qobject_ptr<QNetworkAccessManager> network();
 
+    shared_qobject_ptr<Net::Scheduler> netScheduler();
+
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    std::shared_ptr<Hashing::HashCache> hashCache();
+
+    std::shared_ptr<ModDetailsCache> modDetailsCache();
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     Capabilities currentCapabilities();
@@ -237,11 +253,14 @@ private:
     QDateTime startTime;
 
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    shared_qobject_ptr<Net::Scheduler> m_netScheduler;
 
     shared_qobject_ptr<UpdateChecker> m_updateChecker;
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
+    std::shared_ptr<Hashing::HashCache> m_hashCache;
+    std::shared_ptr<ModDetailsCache> m_modDetailsCache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
 
     std::shared_ptr<SettingsObject> m_settings;
@@ -148,12 +148,6 @@ public:
     QString getManagedPackVersionName();
     void setManagedPack(const QString& type, const QString& id, const QString& name, const QString& versionId, const QString& version);
 
-    /// guess log level from a line of game log
-    virtual MessageLevel::Enum guessLevel(const QString &line, MessageLevel::Enum level)
-    {
-        return level;
-    };
-
     virtual QStringList extraArguments();
 
     /// Traits. Normally inside the version, depends on instance implementation.
@@ -55,9 +55,19 @@
 #include <winnls.h>
 #include <string>
 #else
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 #include <utime.h>
 #endif
 
+#if defined Q_OS_LINUX
+#include <linux/fs.h>
+#elif defined Q_OS_MACOS
+#include <sys/attr.h>
+#include <sys/clonefile.h>
+#endif
+
 namespace FS {
 
 void ensureExists(const QDir& dir)
@@ -179,6 +189,55 @@ bool copy::operator()(const QString& offset)
     return true;
 }
 
+CloneResult cloneFile(const QString& src, const QString& dst, CloneLinks links)
+{
+#if defined Q_OS_WIN32
+    auto nativeSrc = QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath());
+    auto nativeDst = QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath());
+
+    if (links != CloneLinks::None &&
+        CreateHardLinkW(reinterpret_cast<LPCWSTR>(nativeDst.utf16()), reinterpret_cast<LPCWSTR>(nativeSrc.utf16()), nullptr))
+        return CloneResult::Hardlinked;
+
+    // QFile::link() makes shortcuts on Windows, and real symlinks need special privileges. Copy instead.
+#else
+    auto nativeSrc = QFile::encodeName(src);
+    auto nativeDst = QFile::encodeName(dst);
+
+#if defined Q_OS_LINUX && defined FICLONE
+    int srcFd = ::open(nativeSrc.constData(), O_RDONLY | O_CLOEXEC);
+    if (srcFd >= 0) {
+        int dstFd = ::open(nativeDst.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (dstFd >= 0) {
+            bool cloned = ::ioctl(dstFd, FICLONE, srcFd) == 0;
+            ::close(dstFd);
+            if (cloned) {
+                ::close(srcFd);
+                return CloneResult::Reflinked;
+            }
+            // the file system can't do it, don't leave the empty file behind
+            ::unlink(nativeDst.constData());
+        }
+        ::close(srcFd);
+    }
+#elif defined Q_OS_MACOS
+    if (::clonefile(nativeSrc.constData(), nativeDst.constData(), 0) == 0)
+        return CloneResult::Reflinked;
+#endif
+
+    if (links != CloneLinks::None && ::link(nativeSrc.constData(), nativeDst.constData()) == 0)
+        return CloneResult::Hardlinked;
+
+    if (links == CloneLinks::Any && QFile::link(QFileInfo(src).absoluteFilePath(), dst))
+        return CloneResult::Symlinked;
+#endif
+
+    if (QFile::copy(src, dst))
+        return CloneResult::Copied;
+
+    return CloneResult::Failed;
+}
+
 bool deletePath(QString path)
 {
     bool OK = true;
@@ -104,6 +104,21 @@ class copy {
     QDir m_dst;
 };
 
+enum class CloneResult { Failed, Reflinked, Hardlinked, Symlinked, Copied };
+
+/// Which kinds of links cloneFile may make. Anything written to a link changes the original too, so files that
+/// get edited in place must not be links.
+enum class CloneLinks { Any, HardOnly, None };
+
+/**
+ * Create `dst` with the same contents as `src`, sharing the data on disk whenever possible.
+ * In order of preference: reflink (copy-on-write clone), hard link, symbolic link, plain copy.
+ *
+ * `dst` must not exist yet, and its parent folder must.
+ * Returns how the file was created, or CloneResult::Failed.
+ */
+CloneResult cloneFile(const QString& src, const QString& dst, CloneLinks links = CloneLinks::Any);
+
 /**
  * Delete a folder recursively
  */
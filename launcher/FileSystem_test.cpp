@@ -111,6 +111,25 @@ slots:
         f();
     }
 
+    void test_cloneWithoutLinks()
+    {
+        QTemporaryDir tempDir;
+        auto src = FS::PathCombine(tempDir.path(), "object");
+        auto dst = FS::PathCombine(tempDir.path(), "resource");
+        FS::write(src, "shared");
+
+        auto result = FS::cloneFile(src, dst, FS::CloneLinks::None);
+        QVERIFY(result == FS::CloneResult::Reflinked || result == FS::CloneResult::Copied);
+        QVERIFY(!QFileInfo(dst).isSymLink());
+
+        // changing the clone leaves the original alone
+        QFile file(dst);
+        QVERIFY(file.open(QFile::ReadWrite));
+        file.write("edited");
+        file.close();
+        QCOMPARE(FS::read(src), QByteArray("shared"));
+    }
+
     void test_getDesktop()
     {
         QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
@@ -0,0 +1,216 @@
+#include "GZipIndex.h"
+
+#include <QFile>
+#include <QMutexLocker>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+// the most inflate can look back
+static const int s_window_size = 32768;
+// how much output there is between access points, at least
+static const qint64 s_span = 4 * 1024 * 1024;
+// how much of the file is read at once
+static const int s_chunk_size = 64 * 1024;
+
+GZipIndex::GZipIndex(const QString& path) : m_path(path) {}
+
+QString GZipIndex::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+qint64 GZipIndex::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+bool GZipIndex::build(const std::function<void(const char* data, qint64 size)>& on_data,
+                      const std::function<bool(qint64 done, qint64 total)>& on_progress)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_points.clear();
+        m_size = 0;
+        m_spanPoint = -1;
+        m_span.clear();
+    }
+    auto fail = [this](const QString& error) {
+        QMutexLocker locker(&m_mutex);
+        m_error = error;
+        return false;
+    };
+
+    // a file of our own, readers open theirs
+    QFile file(m_path);
+    if (!file.open(QFile::ReadOnly))
+        return fail(file.errorString());
+    const qint64 fileSize = file.size();
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    // gzip only
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK)
+        return fail("Couldn't start inflating");
+
+    QByteArray input(s_chunk_size, Qt::Uninitialized);
+    // the output goes around this, so it always has the last 32 KiB when we need them for an access point
+    QByteArray window(s_window_size, Qt::Uninitialized);
+    auto windowData = reinterpret_cast<Bytef*>(window.data());
+
+    qint64 totalIn = 0;
+    qint64 totalOut = 0;
+    qint64 lastPoint = 0;
+    int ret = Z_OK;
+    do {
+        auto read = file.read(input.data(), input.size());
+        if (read <= 0) {
+            inflateEnd(&strm);
+            return fail(read < 0 ? file.errorString() : "The file ends too early");
+        }
+        if (on_progress && !on_progress(file.pos(), fileSize)) {
+            inflateEnd(&strm);
+            return fail("Stopped");
+        }
+        strm.next_in = reinterpret_cast<Bytef*>(input.data());
+        strm.avail_in = uInt(read);
+        do {
+            if (strm.avail_out == 0) {
+                strm.next_out = windowData;
+                strm.avail_out = s_window_size;
+            }
+            auto out = strm.next_out;
+            totalIn += strm.avail_in;
+            totalOut += strm.avail_out;
+            // stops at the end of each block, those are the places we can pick up from later
+            ret = inflate(&strm, Z_BLOCK);
+            totalIn -= strm.avail_in;
+            totalOut -= strm.avail_out;
+            if (ret == Z_NEED_DICT)
+                ret = Z_DATA_ERROR;
+            if (ret == Z_MEM_ERROR || ret == Z_DATA_ERROR) {
+                QString error = strm.msg ? QString::fromUtf8(strm.msg) : "Invalid compressed data";
+                inflateEnd(&strm);
+                return fail(error);
+            }
+            if (on_data && strm.next_out != out)
+                on_data(reinterpret_cast<const char*>(out), strm.next_out - out);
+            if (ret == Z_STREAM_END)
+                break;
+
+            // at the end of a block that isn't the last one, or right after the header
+            bool blockEnd = (strm.data_type & 128) && !(strm.data_type & 64);
+            if (blockEnd && (totalOut == 0 || totalOut - lastPoint > s_span)) {
+                AccessPoint point;
+                point.out = totalOut;
+                point.in = totalIn;
+                point.bits = strm.data_type & 7;
+                // unwrap the window, oldest first
+                point.window.resize(s_window_size);
+                int left = int(strm.avail_out);
+                if (left)
+                    memcpy(point.window.data(), window.constData() + s_window_size - left, left);
+                if (left < s_window_size)
+                    memcpy(point.window.data() + left, window.constData(), s_window_size - left);
+                // everything before it can be read now
+                QMutexLocker locker(&m_mutex);
+                m_points.append(point);
+                m_size = totalOut;
+                lastPoint = totalOut;
+            }
+        } while (strm.avail_in != 0);
+    } while (ret != Z_STREAM_END);
+
+    inflateEnd(&strm);
+    QMutexLocker locker(&m_mutex);
+    m_size = totalOut;
+    return true;
+}
+
+bool GZipIndex::inflateSpan(int index)
+{
+    auto& point = m_points[index];
+    qint64 end = index + 1 < m_points.size() ? m_points[index + 1].out : m_size;
+    // the last span grows while the index is being built
+    if (m_spanPoint == index && m_span.size() == end - point.out)
+        return true;
+    m_spanPoint = -1;
+    m_span.resize(int(end - point.out));
+
+    QFile file(m_path);
+    if (!file.open(QFile::ReadOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    // no header, we start in the middle
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+        return false;
+
+    file.seek(point.in - (point.bits ? 1 : 0));
+    if (point.bits) {
+        char byte;
+        if (!file.getChar(&byte)) {
+            inflateEnd(&strm);
+            return false;
+        }
+        inflatePrime(&strm, point.bits, uchar(byte) >> (8 - point.bits));
+    }
+    inflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(point.window.constData()), s_window_size);
+
+    QByteArray input(s_chunk_size, Qt::Uninitialized);
+    strm.next_out = reinterpret_cast<Bytef*>(m_span.data());
+    strm.avail_out = uInt(m_span.size());
+    int ret = Z_OK;
+    while (strm.avail_out != 0 && ret != Z_STREAM_END) {
+        if (strm.avail_in == 0) {
+            auto read = file.read(input.data(), input.size());
+            if (read <= 0)
+                break;
+            strm.next_in = reinterpret_cast<Bytef*>(input.data());
+            strm.avail_in = uInt(read);
+        }
+        ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END)
+            break;
+    }
+    inflateEnd(&strm);
+
+    if (strm.avail_out != 0) {
+        // the file changed since we went over it
+        m_error = "Couldn't inflate the file again";
+        return false;
+    }
+    m_spanPoint = index;
+    return true;
+}
+
+QByteArray GZipIndex::read(qint64 offset, qint64 length)
+{
+    QMutexLocker locker(&m_mutex);
+    QByteArray out;
+    length = std::min(length, m_size - offset);
+    if (offset < 0 || length <= 0)
+        return out;
+    out.reserve(int(length));
+
+    while (length > 0) {
+        auto next = std::upper_bound(m_points.cbegin(), m_points.cend(), offset,
+                                     [](qint64 offset, const AccessPoint& point) { return offset < point.out; });
+        int index = int(next - m_points.cbegin()) - 1;
+        if (index < 0 || !inflateSpan(index))
+            return {};
+        auto start = offset - m_points[index].out;
+        auto count = std::min<qint64>(length, m_span.size() - start);
+        out.append(m_span.constData() + start, int(count));
+        offset += count;
+        length -= count;
+    }
+    return out;
+}
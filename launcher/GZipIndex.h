@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * Random access to the uncompressed contents of a gzip file, without keeping them around.
+ *
+ * build() inflates the whole file once and remembers an access point every few MiB of output: where the deflate block
+ * starts in the compressed file and the 32 KiB of output before it, which is all inflate needs to pick up from there.
+ * Reading anything after that only inflates from the closest access point on, and the last span inflated is kept for
+ * reads next to each other.
+ *
+ * Everything before the last access point build() got to can already be read, from another thread, while it's still
+ * going. The file is only open while it's being read.
+ */
+class GZipIndex
+{
+public:
+    explicit GZipIndex(const QString& path);
+
+    /// Go over the whole file, passing everything it uncompresses to, in order, to `on_data`, and how much of the file
+    /// it has read so far to `on_progress`, which can stop it by returning false.
+    /// Returns false if the file can't be read, isn't gzip or it was stopped.
+    /// Has to be started before anything can be read.
+    bool build(const std::function<void(const char* data, qint64 size)>& on_data = {},
+               const std::function<bool(qint64 done, qint64 total)>& on_progress = {});
+    QString errorString() const;
+
+    /// How big the uncompressed contents are, or how much of them can be read so far while it's being built
+    qint64 size() const;
+
+    /// `length` bytes of the uncompressed contents, starting at `offset`
+    QByteArray read(qint64 offset, qint64 length);
+
+private:
+    struct AccessPoint
+    {
+        // where in the uncompressed contents this is
+        qint64 out;
+        // where the block starts in the file, and how many bits of the byte before it belong to it
+        qint64 in;
+        int bits;
+        // the last 32 KiB of output before it
+        QByteArray window;
+    };
+
+    // inflate everything from access point `point` to the next one into m_span
+    bool inflateSpan(int point);
+
+private:
+    QString m_path;
+    // build() adds to m_points and m_size while others read
+    mutable QMutex m_mutex;
+    QString m_error;
+    QVector<AccessPoint> m_points;
+    qint64 m_size = 0;
+
+    int m_spanPoint = -1;
+    QByteArray m_span;
+};
@@ -0,0 +1,97 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "GZipIndex.h"
+
+#include <random>
+
+class GZipIndexTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_read()
+    {
+        // big enough for a few access points, some of it compresses well and some doesn't
+        std::mt19937 rng(42);
+        QByteArray contents;
+        for (int i = 0; contents.size() < 20 * 1024 * 1024; i++) {
+            contents.append(QString("[12:00:00] [main/INFO]: line %1\n").arg(i).toUtf8());
+            if (i % 1000 == 0) {
+                for (int j = 0; j < 4096; j++)
+                    contents.append(char(rng()));
+            }
+        }
+        QByteArray compressed;
+        QVERIFY(GZip::zip(contents, compressed));
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.log.gz");
+        FS::write(path, compressed);
+
+        GZipIndex index(path);
+        QByteArray seen;
+        QVERIFY(index.build([&](const char* data, qint64 size) { seen.append(data, int(size)); }));
+        QCOMPARE(index.size(), qint64(contents.size()));
+        QVERIFY(seen == contents);
+
+        for (int i = 0; i < 200; i++) {
+            qint64 offset = rng() % contents.size();
+            qint64 length = rng() % (i % 10 ? 10000 : 10 * 1024 * 1024);
+            QVERIFY(index.read(offset, length) == contents.mid(int(offset), int(length)));
+        }
+        QVERIFY(index.read(contents.size(), 10).isEmpty());
+    }
+
+    void test_readWhileBuilding()
+    {
+        QByteArray contents;
+        for (int i = 0; contents.size() < 20 * 1024 * 1024; i++)
+            contents.append(QString("[12:00:00] [main/INFO]: line %1\n").arg(i).toUtf8());
+        QByteArray compressed;
+        QVERIFY(GZip::zip(contents, compressed));
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.log.gz");
+        FS::write(path, compressed);
+
+        GZipIndex index(path);
+        qint64 readable = 0;
+        bool same = true;
+        QVERIFY(index.build({}, [&](qint64 done, qint64 total) {
+            Q_UNUSED(done)
+            Q_UNUSED(total)
+            readable = index.size();
+            if (readable > 0)
+                same = same && index.read(readable - 1000, 2000) == contents.mid(int(readable - 1000), 1000);
+            return true;
+        }));
+        QVERIFY(same);
+        QVERIFY(readable > 0 && readable < contents.size());
+        QCOMPARE(index.size(), qint64(contents.size()));
+
+        // stopped half way
+        QVERIFY(!GZipIndex(path).build({}, [](qint64 done, qint64 total) { return done < total / 2; }));
+    }
+
+    void test_invalid()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.log.gz");
+
+        FS::write(path, "not gzip at all");
+        QVERIFY(!GZipIndex(path).build());
+
+        QByteArray compressed;
+        QVERIFY(GZip::zip(QByteArray(100000, 'a') + QByteArray("the end"), compressed));
+        FS::write(path, compressed.left(compressed.size() / 2));
+        QVERIFY(!GZipIndex(path).build());
+
+        QVERIFY(!GZipIndex(FS::PathCombine(dir.path(), "missing.gz")).build());
+    }
+};
+
+QTEST_GUILESS_MAIN(GZipIndexTest)
+
+#include "GZipIndex_test.moc"
@@ -1,7 +1,9 @@
 #include "InstanceCopyTask.h"
 #include "settings/INISettingsObject.h"
+#include "settings/WriteBehindQueue.h"
 #include "FileSystem.h"
 #include "NullInstance.h"
+#include "pathmatcher/MultiMatcher.h"
 #include "pathmatcher/RegexpMatcher.h"
 #include <QtConcurrentRun>
 
@@ -10,18 +12,24 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, bool copySaves, boo
     m_origInstance = origInstance;
     m_keepPlaytime = keepPlaytime;
 
+    auto matcher = new MultiMatcher();
+    // the modded jar is built again on launch, so the copy doesn't need it
+    matcher->add(std::make_shared<RegexpMatcher>("^[.]?minecraft/bin/minecraft[.]jar([.]key|[.]tmp)?$"));
     if(!copySaves)
     {
         // FIXME: get this from the original instance type...
-        auto matcherReal = new RegexpMatcher("[.]?minecraft/saves");
+        auto matcherReal = std::make_shared<RegexpMatcher>("[.]?minecraft/saves");
         matcherReal->caseSensitive(false);
-        m_matcher.reset(matcherReal);
+        matcher->add(matcherReal);
     }
+    m_matcher.reset(matcher);
 }
 
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
+    // copy the settings as they are now, not as they were last written
+    WriteBehindQueue::instance().flush();
 
     FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
     folderCopy.followSymlinks(false).blacklist(m_matcher.get());
@@ -70,10 +70,21 @@ InstanceImportTask::InstanceImportTask(const QUrl sourceUrl, QWidget* parent)
     m_parent = parent;
 }
 
+InstanceImportTask::~InstanceImportTask()
+{
+    for (const auto& link : m_storeLinks)
+        m_modStore.unpin(link.algorithm, link.hash);
+}
+
 bool InstanceImportTask::abort()
 {
+    m_aborted = true;
     if (m_filesNetJob)
         m_filesNetJob->abort();
+    if (m_packIndexFetch)
+        m_packIndexFetch->abort();
+    if (m_prefetchJob)
+        m_prefetchJob->abort();
     m_extractFuture.cancel();
 
     return false;
@@ -102,7 +113,90 @@ void InstanceImportTask::executeTask()
         connect(job, &NetJob::progress, this, &InstanceImportTask::downloadProgressChanged);
         connect(job, &NetJob::failed, this, &InstanceImportTask::downloadFailed);
         m_filesNetJob->start();
+        // Only Modrinth packs list everything we need to download, hashes included, right in their index.
+        // Don't go asking other servers for parts of whatever they have there.
+        if (m_sourceUrl.path().endsWith(".mrpack", Qt::CaseInsensitive))
+            startPrefetch();
+    }
+}
+
+// The hash we go by for a file of a Modrinth pack, the same everywhere so we end up with the same blob for it.
+// Empty if it has none we know.
+static QString preferredModrinthHash(const QJsonObject& hashes, QCryptographicHash::Algorithm& algorithm)
+{
+    static const std::pair<const char*, QCryptographicHash::Algorithm> preference[] = {
+        { "sha1", QCryptographicHash::Sha1 }, { "sha512", QCryptographicHash::Sha512 }, { "sha256", QCryptographicHash::Sha256 }
+    };
+    for (auto& [name, candidate] : preference) {
+        auto hash = Json::ensureString(hashes, name);
+        if (!hash.isEmpty()) {
+            algorithm = candidate;
+            return hash;
+        }
     }
+    return {};
+}
+
+void InstanceImportTask::startPrefetch()
+{
+    m_packIndexFetch = new Net::RemoteZipEntry(m_sourceUrl, "modrinth.index.json", APPLICATION->network());
+    connect(m_packIndexFetch.get(), &Task::succeeded, this, [this] {
+        auto index = m_packIndexFetch->contents();
+        m_packIndexFetch.reset();
+        prefetchModrinthFiles(index);
+    });
+    connect(m_packIndexFetch.get(), &Task::failed, this, [this](QString reason) {
+        qDebug() << "Not downloading mods early:" << reason;
+        m_packIndexFetch.reset();
+    });
+    m_packIndexFetch->start();
+}
+
+void InstanceImportTask::prefetchModrinthFiles(const QByteArray& index)
+{
+    QList<Net::Download::Ptr> downloads;
+    try {
+        auto obj = Json::requireObject(Json::requireDocument(index, "modrinth.index.json"), "modrinth.index.json");
+        if (Json::requireInteger(obj, "formatVersion", "modrinth.index.json") != 1)
+            return;
+
+        QSet<QString> queued;
+        for (auto modInfo : Json::requireIsArrayOf<QJsonObject>(obj, "files", "modrinth.index.json")) {
+            auto env = Json::ensureObject(modInfo, "env");
+            if (!env.isEmpty() && Json::ensureString(env, "client", "unsupported") == "unsupported")
+                continue;
+
+            auto urls = Json::ensureArray(modInfo, "downloads");
+            if (urls.isEmpty())
+                continue;
+            QUrl url(urls.first().toString());
+
+            QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha1;
+            auto hash = preferredModrinthHash(Json::requireObject(modInfo, "hashes"), algorithm);
+
+            auto rawHash = QByteArray::fromHex(hash.toLatin1());
+            auto blob = m_modStore.blobPath(algorithm, rawHash);
+            if (!url.isValid() || blob.isEmpty() || queued.contains(blob) || m_modStore.contains(algorithm, rawHash))
+                continue;
+            queued.insert(blob);
+            downloads.append(m_modStore.makeDownload(url, algorithm, rawHash));
+        }
+    } catch (const JSONValidationError& e) {
+        // the real import will complain about it
+        qDebug() << "Not downloading mods early, the pack index is not valid:" << e.cause();
+        return;
+    }
+
+    if (downloads.isEmpty())
+        return;
+
+    qDebug() << "Downloading" << downloads.size() << "mods while the pack is still downloading";
+    m_prefetchJob = new NetJob(tr("Mod download"), APPLICATION->network());
+    for (auto& dl : downloads)
+        m_prefetchJob->addNetAction(dl);
+    // whatever didn't make it will be downloaded again by the import itself
+    connect(m_prefetchJob.get(), &NetJob::failed, this, [](QString reason) { qDebug() << "Some mods couldn't be downloaded early:" << reason; });
+    m_prefetchJob->start();
 }
 
 void InstanceImportTask::downloadSucceeded()
@@ -436,8 +530,9 @@ void InstanceImportTask::processFlame()
                         case Flame::File::Type::Mod: {
                             if (!result.url.isEmpty()) {
                                 qDebug() << "Will download" << result.url << "to" << path;
-                                auto dl = Net::Download::makeFile(result.url, path);
-                                m_filesNetJob->addNetAction(dl);
+                                auto dl = makeModDownload(result.url, QCryptographicHash::Sha1, QByteArray::fromHex(result.hash.toLatin1()), path);
+                                if (dl)
+                                    m_filesNetJob->addNetAction(dl);
                             }
                             break;
                         }
@@ -456,7 +551,7 @@ void InstanceImportTask::processFlame()
                 m_modIdResolver.reset();
                 connect(m_filesNetJob.get(), &NetJob::succeeded, this, [&]() {
                             m_filesNetJob.reset();
-                            emitSucceeded();
+                            linkStoredModsAndSucceed();
                         }
                 );
                 connect(m_filesNetJob.get(), &NetJob::failed, [&](QString reason) {
@@ -493,8 +588,9 @@ void InstanceImportTask::processFlame()
                     case Flame::File::Type::Mod: {
                         if (!result.url.isEmpty()) {
                             qDebug() << "Will download" << result.url << "to" << path;
-                            auto dl = Net::Download::makeFile(result.url, path);
-                            m_filesNetJob->addNetAction(dl);
+                            auto dl = makeModDownload(result.url, QCryptographicHash::Sha1, QByteArray::fromHex(result.hash.toLatin1()), path);
+                            if (dl)
+                                m_filesNetJob->addNetAction(dl);
                         }
                         break;
                     }
@@ -513,7 +609,7 @@ void InstanceImportTask::processFlame()
             m_modIdResolver.reset();
             connect(m_filesNetJob.get(), &NetJob::succeeded, this, [&]() {
                         m_filesNetJob.reset();
-                        emitSucceeded();
+                        linkStoredModsAndSucceed();
                     }
             );
             connect(m_filesNetJob.get(), &NetJob::failed, [&](QString reason) {
@@ -628,21 +724,10 @@ void InstanceImportTask::processModrinth()
                     }
                 }
 
-                QJsonObject hashes = Json::requireObject(modInfo, "hashes");
-                QString hash;
-                QCryptographicHash::Algorithm hashAlgorithm;
-                hash = Json::ensureString(hashes, "sha1");
-                hashAlgorithm = QCryptographicHash::Sha1;
+                QCryptographicHash::Algorithm hashAlgorithm = QCryptographicHash::Sha1;
+                QString hash = preferredModrinthHash(Json::requireObject(modInfo, "hashes"), hashAlgorithm);
                 if (hash.isEmpty()) {
-                    hash = Json::ensureString(hashes, "sha512");
-                    hashAlgorithm = QCryptographicHash::Sha512;
-                    if (hash.isEmpty()) {
-                        hash = Json::ensureString(hashes, "sha256");
-                        hashAlgorithm = QCryptographicHash::Sha256;
-                        if (hash.isEmpty()) {
-                            throw JSONValidationError("No hash found for: " + file.path);
-                        }
-                    }
+                    throw JSONValidationError("No hash found for: " + file.path);
                 }
                 file.hash = QByteArray::fromHex(hash.toLatin1());
                 file.hashAlgorithm = hashAlgorithm;
@@ -741,21 +826,52 @@ void InstanceImportTask::processModrinth()
     instance.setName(m_instName);
     instance.saveNow();
 
+    downloadModrinthFiles(files);
+}
+
+void InstanceImportTask::downloadModrinthFiles(std::vector<Modrinth::File> files)
+{
+    if (m_packIndexFetch)
+    {
+        // too late for that
+        m_packIndexFetch->abort();
+    }
+    if (m_prefetchJob && m_prefetchJob->isRunning())
+    {
+        // let it finish, so we don't download the same files twice
+        setStatus(tr("Downloading mods..."));
+        connect(m_prefetchJob.get(), &Task::finished, this, [this, files]() {
+            m_prefetchJob.reset();
+            // that's what aborting it looks like, and nothing else is left to say we stopped
+            if (m_aborted) {
+                emitFailed(tr("Instance import has been aborted."));
+                return;
+            }
+            downloadModrinthFiles(files);
+        });
+        return;
+    }
+    m_prefetchJob.reset();
+
     m_filesNetJob = new NetJob(tr("Mod download"), APPLICATION->network());
     for (auto file : files)
     {
         auto path = FS::PathCombine(m_stagingPath, ".minecraft", file.path);
         qDebug() << "Will try to download" << file.downloads.front() << "to" << path;
-        auto dl = Net::Download::makeFile(file.downloads.dequeue(), path);
-        dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+        auto dl = makeModDownload(file.downloads.dequeue(), file.hashAlgorithm, file.hash, path);
+        if (!dl)
+            continue;
         m_filesNetJob->addNetAction(dl);
 
         if (file.downloads.size() > 0) {
             // FIXME: This really needs to be put into a ConcurrentTask of
             // MultipleOptionsTask's , once those exist :)
-            connect(dl.get(), &NetAction::failed, [this, &file, path, dl]{
-                auto dl = Net::Download::makeFile(file.downloads.dequeue(), path);
-                dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+            connect(dl.get(), &NetAction::failed, [this, file, path]() mutable {
+                // to wherever the first try was going to put it, which already has its link if that's the store
+                auto url = file.downloads.dequeue();
+                auto dl = m_modStore.blobPath(file.hashAlgorithm, file.hash).isEmpty()
+                              ? Net::Download::makeFile(url, path)
+                              : m_modStore.makeDownload(url, file.hashAlgorithm, file.hash);
                 m_filesNetJob->addNetAction(dl);
                 dl->succeeded();
             });
@@ -764,7 +880,7 @@ void InstanceImportTask::processModrinth()
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, [&]()
             {
                 m_filesNetJob.reset();
-                emitSucceeded();
+                linkStoredModsAndSucceed();
             }
     );
     connect(m_filesNetJob.get(), &NetJob::failed, [&](const QString &reason)
@@ -779,3 +895,48 @@ void InstanceImportTask::processModrinth()
     setStatus(tr("Downloading mods..."));
     m_filesNetJob->start();
 }
+
+Net::Download::Ptr InstanceImportTask::makeModDownload(QUrl url, QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& path)
+{
+    auto blob = m_modStore.blobPath(algorithm, hash);
+    if (blob.isEmpty())
+    {
+        // no hash we can use, so it can't be shared
+        return Net::Download::makeFile(url, path);
+    }
+
+    // before checking whether it's there, so it can't be collected in between
+    m_modStore.pin(algorithm, hash);
+    m_storeLinks.append({ algorithm, hash, path });
+    if (m_queuedBlobs.contains(blob) || m_modStore.contains(algorithm, hash))
+    {
+        return nullptr;
+    }
+    m_queuedBlobs.insert(blob);
+    return m_modStore.makeDownload(url, algorithm, hash);
+}
+
+void InstanceImportTask::linkStoredModsAndSucceed()
+{
+    setStatus(tr("Installing mods..."));
+    for (const auto& link : m_storeLinks)
+    {
+        if (!m_modStore.link(link))
+        {
+            emitFailed(tr("Could not install %1 from the mod store.").arg(QFileInfo(link.target).fileName()));
+            return;
+        }
+    }
+    m_queuedBlobs.clear();
+    emitSucceeded();
+}
+
+void InstanceImportTask::instanceCommitted(const QString& instanceRoot)
+{
+    // the links were made in the staging folder, which is gone now
+    QDir staging(m_stagingPath);
+    for (const auto& link : m_storeLinks)
+    {
+        m_modStore.addRef({ link.algorithm, link.hash, FS::PathCombine(instanceRoot, staging.relativeFilePath(link.target)) });
+    }
+}
@@ -43,20 +43,28 @@
 #include "settings/SettingsObject.h"
 #include "QObjectPtr.h"
 #include "modplatform/flame/PackManifest.h"
+#include "modplatform/helpers/ModStore.h"
+#include "net/RemoteZipEntry.h"
 
 #include <optional>
+#include <vector>
 
 class QuaZip;
 namespace Flame
 {
     class FileResolvingTask;
 }
+namespace Modrinth
+{
+    struct File;
+}
 
 class InstanceImportTask : public InstanceTask
 {
     Q_OBJECT
 public:
     explicit InstanceImportTask(const QUrl sourceUrl, QWidget* parent = nullptr);
+    virtual ~InstanceImportTask();
 
     bool canAbort() const override { return true; }
     bool abort() override;
@@ -65,6 +73,8 @@ public:
         return m_blockedMods;
     }
 
+    void instanceCommitted(const QString &instanceRoot) override;
+
 protected:
     //! Entry point for tasks.
     virtual void executeTask() override;
@@ -75,6 +85,15 @@ private:
     void processTechnic();
     void processFlame();
     void processModrinth();
+    void downloadModrinthFiles(std::vector<Modrinth::File> files);
+    /// Start downloading the mods of a remote pack into the mod store, while the pack itself is still downloading
+    void startPrefetch();
+    void prefetchModrinthFiles(const QByteArray& index);
+    /// Download through the mod store when we know the hash of the file, pinning it there until we're done.
+    /// Null if there is nothing to download.
+    Net::Download::Ptr makeModDownload(QUrl url, QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& path);
+    /// Put the mods downloaded through the store into the staged instance, and finish
+    void linkStoredModsAndSucceed();
 
 private slots:
     void downloadSucceeded();
@@ -85,6 +104,8 @@ private slots:
 
 private: /* data */
     NetJob::Ptr m_filesNetJob;
+    Net::RemoteZipEntry::Ptr m_packIndexFetch;
+    NetJob::Ptr m_prefetchJob;
     shared_qobject_ptr<Flame::FileResolvingTask> m_modIdResolver;
     QUrl m_sourceUrl;
     QString m_archivePath;
@@ -93,6 +114,11 @@ private: /* data */
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
     QVector<Flame::File> m_blockedMods;
+    ModStore m_modStore;
+    // the mods linked from the store, pinned there until this goes away
+    QList<ModStore::Link> m_storeLinks;
+    QSet<QString> m_queuedBlobs;
+    bool m_aborted = false;
     enum class ModpackType{
         Unknown,
         MultiMC,
@@ -48,6 +48,7 @@
 #include <QThread>
 #include <QTimer>
 #include <QUuid>
+#include <QtConcurrent>
 #include <QXmlStreamReader>
 
 #include "BaseInstance.h"
@@ -58,7 +59,9 @@
 #include "NullInstance.h"
 #include "WatchLock.h"
 #include "minecraft/MinecraftInstance.h"
+#include "modplatform/helpers/ModStore.h"
 #include "settings/INISettingsObject.h"
+#include "settings/WriteBehindQueue.h"
 
 #ifdef Q_OS_WIN32
 #include <Windows.h>
@@ -304,8 +307,13 @@ bool InstanceList::trashInstance(const InstanceId& id)
         saveGroupList();
     }
 
+    // the trashed folder gets the latest settings, and nothing written late brings an empty one back in its place
+    WriteBehindQueue::instance().flush();
+    WriteBehindQueue::instance().ignoreDirectory(inst->instanceRoot());
+
     if (!FS::trash(inst->instanceRoot(), &trashedLoc)) {
         qDebug() << "Trash of instance" << id << "has not been completely successfully...";
+        WriteBehindQueue::instance().stopIgnoringDirectory(inst->instanceRoot());
         return false;
     }
 
@@ -333,6 +341,7 @@ void InstanceList::undoTrashInstance() {
     }
 
     qDebug() << "Moving" << top.trashPath << "back to" << top.polyPath;
+    WriteBehindQueue::instance().stopIgnoringDirectory(top.polyPath);
     QFile(top.trashPath).rename(top.polyPath);
 
     m_instanceGroupIndex[top.id] = top.groupName;
@@ -354,13 +363,22 @@ void InstanceList::deleteInstance(const InstanceId& id)
         saveGroupList();
     }
 
+    // don't let a late settings write bring any of it back
+    WriteBehindQueue::instance().flush();
+    WriteBehindQueue::instance().ignoreDirectory(inst->instanceRoot());
+
     qDebug() << "Will delete instance" << id;
     if (!FS::deletePath(inst->instanceRoot())) {
         qWarning() << "Deletion of instance" << id << "has not been completely successful ...";
+        WriteBehindQueue::instance().stopIgnoringDirectory(inst->instanceRoot());
         return;
     }
 
     qDebug() << "Instance" << id << "has been deleted by the launcher.";
+
+    // the instance may have been the last one using some of the shared mods
+    auto collector = QtConcurrent::run(QThreadPool::globalInstance(), [] { ModStore().collectGarbage(); });
+    Q_UNUSED(collector);
 }
 
 static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr>& list)
@@ -766,7 +784,7 @@ class InstanceStaging : public Task {
     const unsigned maxBackoff = 16;
 
    public:
-    InstanceStaging(InstanceList* parent, Task* child, const QString& stagingPath, const QString& instanceName, const QString& groupName)
+    InstanceStaging(InstanceList* parent, InstanceTask* child, const QString& stagingPath, const QString& instanceName, const QString& groupName)
         : backoff(minBackoff, maxBackoff)
     {
         m_parent = parent;
@@ -808,7 +826,9 @@ class InstanceStaging : public Task {
     void childSucceded()
     {
         unsigned sleepTime = backoff();
-        if (m_parent->commitStagedInstance(m_stagingPath, m_instanceName, m_groupName)) {
+        auto instanceRoot = m_parent->commitStagedInstance(m_stagingPath, m_instanceName, m_groupName);
+        if (!instanceRoot.isEmpty()) {
+            m_child->instanceCommitted(instanceRoot);
             emitSucceeded();
             return;
         }
@@ -835,7 +855,7 @@ class InstanceStaging : public Task {
     ExponentialSeries backoff;
     QString m_stagingPath;
     InstanceList* m_parent;
-    unique_qobject_ptr<Task> m_child;
+    unique_qobject_ptr<InstanceTask> m_child;
     QString m_instanceName;
     QString m_groupName;
     QTimer m_backoffTimer;
@@ -866,16 +886,20 @@ QString InstanceList::getStagedInstancePath()
     return path;
 }
 
-bool InstanceList::commitStagedInstance(const QString& path, const QString& instanceName, const QString& groupName)
+QString InstanceList::commitStagedInstance(const QString& path, const QString& instanceName, const QString& groupName)
 {
     QDir dir;
     QString instID = FS::DirNameFromString(instanceName, m_instDir);
+    QString destination = FS::PathCombine(m_instDir, instID);
+    // the settings of the new instance have to be in the folder before it moves
+    WriteBehindQueue::instance().flush();
+    // a folder by that name may have been removed before
+    WriteBehindQueue::instance().stopIgnoringDirectory(destination);
     {
         WatchLock lock(m_watcher, m_instDir);
-        QString destination = FS::PathCombine(m_instDir, instID);
         if (!dir.rename(path, destination)) {
             qWarning() << "Failed to move" << path << "to" << destination;
-            return false;
+            return QString();
         }
         m_instanceGroupIndex[instID] = groupName;
         instanceSet.insert(instID);
@@ -884,7 +908,7 @@ bool InstanceList::commitStagedInstance(const QString& path, const QString& inst
         emit instanceSelectRequest(instID);
     }
     saveGroupList();
-    return true;
+    return destination;
 }
 
 bool InstanceList::destroyStagingPath(const QString& keyPath)
@@ -127,8 +127,9 @@ public:
     /**
      * Commit the staging area given by @keyPath to the provider - used when creation succeeds.
      * Used by instance manipulation tasks.
+     * @return where the instance ended up, empty on failure
      */
-    bool commitStagedInstance(const QString & keyPath, const QString& instanceName, const QString & groupName);
+    QString commitStagedInstance(const QString & keyPath, const QString& instanceName, const QString & groupName);
 
     /**
      * Destroy a previously created staging area given by @keyPath - used when creation fails.
@@ -43,6 +43,12 @@ public:
         return m_instGroup;
     }
 
+    /// Called once the staging area was committed, so the instance is at `instanceRoot` for good
+    virtual void instanceCommitted(const QString &instanceRoot)
+    {
+        Q_UNUSED(instanceRoot);
+    }
+
 protected: /* data */
     SettingsObjectPtr m_globalSettings;
     QString m_instName;
@@ -40,6 +40,16 @@
 #include "FileSystem.h"
 
 #include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <atomic>
+
+#if defined Q_OS_WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 // ours
 bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, const FilterFunction filter)
@@ -66,15 +76,25 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly))
+        QuaZipFileInfo64 info_in;
+        if (!modZip.getCurrentFileInfo(&info_in))
+        {
+            qCritical() << "Failed to read the entry of " << filename << " from " << from.fileName();
+            return false;
+        }
+
+        // Copy the compressed data as it is, there's no point in inflating and deflating it again.
+        int method, level;
+        if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true))
         {
             qCritical() << "Failed to open " << filename << " from " << from.fileName();
             return false;
         }
 
-        QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+        // keeps the name, timestamps, attributes and the uncompressed size
+        QuaZipNewInfo info_out(info_in);
 
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
+        if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info_in.crc, method, level, true))
         {
             qCritical() << "Failed to open " << filename << " in the jar";
             fileInsideMod.close();
@@ -89,6 +109,11 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         zipOutFile.close();
         fileInsideMod.close();
+        if (zipOutFile.getZipError() != 0)
+        {
+            qCritical() << "Failed to finish " << filename << " in the jar";
+            return false;
+        }
     }
     return true;
 }
@@ -270,6 +295,12 @@ bool MMCZip::findFilesInZip(QuaZip * zip, const QString & what, QStringList & re
 // ours
 std::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString & subdir, const QString &target)
 {
+    // archives that are files on disk can be read by several threads at once
+    if (!zip->getZipName().isEmpty())
+    {
+        return extractSubDirParallel(zip->getZipName(), subdir, target);
+    }
+
     QDir directory(target);
     QStringList extracted;
 
@@ -334,6 +365,184 @@ std::optional<QStringList> MMCZip::extractSubDir(QuaZip *zip, const QString & su
     return extracted;
 }
 
+namespace {
+struct ExtractJob
+{
+    /// position of the entry in the central directory
+    int index;
+    QString name;
+    QString target;
+};
+
+struct ExtractRange
+{
+    QVector<ExtractJob> jobs;
+};
+
+bool syncFile(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#if defined Q_OS_WIN32
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+bool extractRange(const QString &archivePath, const ExtractRange &range, bool syncFiles, std::atomic<bool> &failed)
+{
+    QuaZip zip(archivePath);
+    if (!zip.open(QuaZip::mdUnzip))
+    {
+        qWarning() << "Could not open archive for unzipping:" << archivePath << "Error:" << zip.getZipError();
+        return false;
+    }
+
+    // walking the central directory is cheap, looking entries up by name is not
+    int current = 0;
+    bool more = zip.goToFirstFile();
+    QByteArray buffer(256 * 1024, Qt::Uninitialized);
+    for (const auto &job : range.jobs)
+    {
+        if (failed)
+            return false;
+
+        while (more && current < job.index)
+        {
+            more = zip.goToNextFile();
+            current++;
+        }
+        if (!more || zip.getCurrentFileName() != job.name)
+        {
+            qWarning() << "Lost track of" << job.name << "in" << archivePath;
+            return false;
+        }
+
+        QuaZipFile in(&zip);
+        if (!in.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Failed to open" << job.name << "in" << archivePath;
+            return false;
+        }
+        QFile out(job.target);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            qWarning() << "Failed to create" << job.target << ":" << out.errorString();
+            return false;
+        }
+        qint64 count;
+        while ((count = in.read(buffer.data(), buffer.size())) > 0)
+        {
+            if (out.write(buffer.constData(), count) != count)
+            {
+                qWarning() << "Failed to write" << job.target << ":" << out.errorString();
+                return false;
+            }
+        }
+        in.close();
+        if (count < 0 || in.getZipError() != UNZ_OK)
+        {
+            qWarning() << "Failed to extract" << job.name << "from" << archivePath;
+            return false;
+        }
+        if (syncFiles && !syncFile(out))
+        {
+            qWarning() << "Failed to sync" << job.target;
+            return false;
+        }
+        out.close();
+        out.setPermissions(QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser);
+    }
+    return true;
+}
+}
+
+std::optional<QStringList> MMCZip::extractSubDirParallel(const QString &archivePath, const QString &subdir, const QString &target,
+                                                         const ExtractOptions &options)
+{
+    QuaZip zip(archivePath);
+    if (!zip.open(QuaZip::mdUnzip))
+    {
+        qWarning() << "Could not open archive for unzipping:" << archivePath << "Error:" << zip.getZipError();
+        return std::nullopt;
+    }
+
+    qDebug() << "Extracting subdir" << subdir << "from" << archivePath << "to" << target;
+    auto entries = zip.getFileNameList();
+    if (zip.getZipError() != UNZ_OK)
+    {
+        qWarning() << "Failed to enumerate files in archive";
+        return std::nullopt;
+    }
+    zip.close();
+
+    QDir directory(target);
+    auto root = QDir::cleanPath(directory.absolutePath());
+    QStringList extracted;
+    QSet<QString> folders;
+    QVector<ExtractJob> jobs;
+    for (int i = 0; i < entries.size(); i++)
+    {
+        auto name = entries[i];
+        if (!name.startsWith(subdir))
+            continue;
+
+        auto relative = name.mid(subdir.size());
+        auto absFilePath = relative.isEmpty() ? root + "/" : directory.absoluteFilePath(relative);
+        auto cleaned = QDir::cleanPath(absFilePath);
+        if (cleaned != root && !cleaned.startsWith(root + "/"))
+        {
+            qWarning() << "Refusing to extract" << name << "outside of" << target;
+            return std::nullopt;
+        }
+
+        extracted.append(absFilePath);
+        if (relative.isEmpty() || relative.endsWith('/'))
+        {
+            folders.insert(cleaned);
+            continue;
+        }
+        folders.insert(QFileInfo(cleaned).path());
+        jobs.append({ i, name, cleaned });
+    }
+
+    // create all the folders first, so the threads don't have to
+    for (const auto &folder : folders)
+    {
+        if (!FS::ensureFolderPathExists(folder))
+        {
+            qWarning() << "Failed to create folder" << folder;
+            return std::nullopt;
+        }
+    }
+
+    int threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+    // not worth opening the archive again for a handful of files
+    threads = std::max(1, std::min(threads, int(jobs.size() / 32)));
+
+    QVector<ExtractRange> ranges(threads);
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        ranges[int(qint64(i) * threads / jobs.size())].jobs.append(jobs[i]);
+    }
+
+    std::atomic<bool> failed { false };
+    QtConcurrent::blockingMap(ranges, [&](ExtractRange &range) {
+        if (!extractRange(archivePath, range, options.syncFiles, failed))
+            failed = true;
+    });
+
+    if (failed)
+    {
+        qWarning() << "Failed to extract" << subdir << "from" << archivePath;
+        JlCompress::removeFile(extracted);
+        return std::nullopt;
+    }
+    qDebug() << "Extracted" << jobs.size() << "files with" << threads << "threads";
+    return extracted;
+}
+
 // ours
 bool MMCZip::extractRelFile(QuaZip *zip, const QString &file, const QString &target)
 {
@@ -97,6 +97,25 @@ namespace MMCZip
      */
     std::optional<QStringList> extractSubDir(QuaZip *zip, const QString & subdir, const QString &target);
 
+    struct ExtractOptions
+    {
+        /// how many files to extract at the same time, 0 for one per core
+        int threads = 0;
+        /// flush every file to the disk before returning. Safer, but a lot slower on most file systems
+        bool syncFiles = false;
+    };
+
+    /**
+     * Extract a subdirectory from an archive file, with several threads
+     *
+     * The entries are split in contiguous ranges between the threads, and each thread reads through its own handle
+     * to the archive. All the folders are created before any file is extracted.
+     *
+     * \return The list of the full paths of the files extracted, in archive order. Empty optional on failure.
+     */
+    std::optional<QStringList> extractSubDirParallel(const QString &archivePath, const QString &subdir, const QString &target,
+                                                     const ExtractOptions &options = {});
+
     bool extractRelFile(QuaZip *zip, const QString & file, const QString &target);
 
     /**
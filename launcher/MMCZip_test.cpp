@@ -0,0 +1,227 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+
+#include "FileSystem.h"
+#include "MMCZip.h"
+
+#include <random>
+
+class MMCZipTest : public QObject {
+    Q_OBJECT
+
+    // Somewhat compressible contents, like class files are.
+    static QByteArray makeContents(std::mt19937& rng, int size)
+    {
+        static const char* words[] = { "java/lang/Object", "net/minecraft/", "Code", "LineNumberTable", "<init>", "()V", "I", "Ljava/lang/String;" };
+        QByteArray data;
+        data.reserve(size + 32);
+        while (data.size() < size) {
+            data += words[rng() % 8];
+            data += char(rng() % 256);
+        }
+        data.truncate(size);
+        return data;
+    }
+
+    static void makeJar(const QString& path, const QString& prefix, int count, int entry_size)
+    {
+        std::mt19937 rng(count);
+        QuaZip zip(path);
+        QVERIFY(zip.open(QuaZip::mdCreate));
+        QuaZipFile file(&zip);
+        for (int i = 0; i < count; i++) {
+            QVERIFY(file.open(QIODevice::WriteOnly, QuaZipNewInfo(QString("%1/C%2.class").arg(prefix).arg(i))));
+            file.write(makeContents(rng, entry_size));
+            file.close();
+        }
+        QVERIFY(file.open(QIODevice::WriteOnly, QuaZipNewInfo("META-INF/MANIFEST.MF")));
+        file.write("Manifest-Version: 1.0\n");
+        file.close();
+        zip.close();
+        QCOMPARE(zip.getZipError(), 0);
+    }
+
+    static QMap<QString, QByteArray> readJar(const QString& path)
+    {
+        QMap<QString, QByteArray> contents;
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdUnzip))
+            return contents;
+        QuaZipFile file(&zip);
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            file.open(QIODevice::ReadOnly);
+            contents.insert(zip.getCurrentFileName(), file.readAll());
+            file.close();
+        }
+        return contents;
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    // What mergeZipFiles() used to do, kept around to compare against.
+    static bool mergeRecompressing(QuaZip* into, QFileInfo from, QSet<QString>& contained, const MMCZip::FilterFunction filter = nullptr)
+    {
+        QuaZip modZip(from.filePath());
+        modZip.open(QuaZip::mdUnzip);
+
+        QuaZipFile fileInsideMod(&modZip);
+        QuaZipFile zipOutFile(into);
+        for (bool more = modZip.goToFirstFile(); more; more = modZip.goToNextFile()) {
+            QString filename = modZip.getCurrentFileName();
+            if ((filter && !filter(filename)) || contained.contains(filename))
+                continue;
+            contained.insert(filename);
+
+            if (!fileInsideMod.open(QIODevice::ReadOnly))
+                return false;
+            if (!zipOutFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileInsideMod.getActualFileName()))) {
+                fileInsideMod.close();
+                return false;
+            }
+            JlCompress::copyData(fileInsideMod, zipOutFile);
+            zipOutFile.close();
+            fileInsideMod.close();
+        }
+        return true;
+    }
+
+    // ~20 MB of classes, so there's something to measure
+    static const int s_classes = 2500;
+    static const int s_classSize = 8192;
+#else
+    static const int s_classes = 500;
+    static const int s_classSize = 256;
+#endif
+
+    QTemporaryDir m_dir;
+    QString m_clientJar;
+    QList<Mod*> m_mods;
+
+   private slots:
+    void initTestCase()
+    {
+        // a client jar, plus a few jar mods replacing some of its classes
+        m_clientJar = FS::PathCombine(m_dir.path(), "client.jar");
+        makeJar(m_clientJar, "net/minecraft", s_classes, s_classSize);
+        for (int i = 0; i < 4; i++) {
+            auto path = FS::PathCombine(m_dir.path(), QString("mod%1.jar").arg(i));
+            makeJar(path, "net/minecraft", 50 * (i + 1), 4096);
+            m_mods.append(new Mod(QFileInfo(path)));
+        }
+    }
+
+    void cleanupTestCase() { qDeleteAll(m_mods); }
+
+    void test_createModdedJar()
+    {
+        auto target = FS::PathCombine(m_dir.path(), "modded.jar");
+        QVERIFY(MMCZip::createModdedJar(m_clientJar, target, m_mods));
+
+        auto result = readJar(target);
+        auto client = readJar(m_clientJar);
+        auto lastMod = readJar(m_mods.last()->fileinfo().absoluteFilePath());
+
+        // the manifest comes from the last jar mod, the client one is filtered out
+        QCOMPARE(result.value("META-INF/MANIFEST.MF"), lastMod.value("META-INF/MANIFEST.MF"));
+        // the last mod wins
+        QCOMPARE(result.value("net/minecraft/C0.class"), lastMod.value("net/minecraft/C0.class"));
+        // untouched classes come through as they were
+        auto untouched = QString("net/minecraft/C%1.class").arg(s_classes - 1);
+        QCOMPARE(result.value(untouched), client.value(untouched));
+        QCOMPARE(result.size(), client.size());
+
+        // the copied entries still check out
+        QuaZip zip(target);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QuaZipFile file(&zip);
+        for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            file.readAll();
+            file.close();
+            QCOMPARE(file.getZipError(), UNZ_OK);
+        }
+    }
+
+    void test_extractSubDir()
+    {
+        QTemporaryDir dir;
+        auto archive = FS::PathCombine(dir.path(), "pack.zip");
+        makeJar(archive, "overrides/config/deep/er", 200, 100);
+
+        auto target = FS::PathCombine(dir.path(), "out");
+        auto extracted = MMCZip::extractSubDirParallel(archive, "overrides/", target, { 4, false });
+        QVERIFY(extracted);
+        // everything in the subdir, nothing outside of it
+        QCOMPARE(extracted->size(), 200);
+        QVERIFY(!QFile::exists(FS::PathCombine(target, "META-INF")));
+
+        auto contents = readJar(archive);
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/deep/er/C0.class")), contents.value("overrides/config/deep/er/C0.class"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/deep/er/C199.class")), contents.value("overrides/config/deep/er/C199.class"));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_extract_data()
+    {
+        QTest::addColumn<bool>("parallel");
+
+        QTest::newRow("single handle") << false;
+        QTest::newRow("parallel") << true;
+    }
+    void benchmark_extract()
+    {
+        QFETCH(bool, parallel);
+
+        // lots of small config files, like big packs have in their overrides
+        QTemporaryDir dir;
+        auto archive = FS::PathCombine(dir.path(), "pack.zip");
+        makeJar(archive, "overrides/config", 5000, 1024);
+        auto target = FS::PathCombine(dir.path(), "out");
+
+        QBENCHMARK
+        {
+            if (parallel) {
+                QVERIFY(MMCZip::extractSubDirParallel(archive, "overrides/", target));
+            } else {
+                // without a file name, the archive can only be read through the one handle
+                QFile file(archive);
+                QuaZip zip(&file);
+                QVERIFY(zip.open(QuaZip::mdUnzip));
+                QVERIFY(MMCZip::extractSubDir(&zip, "overrides/", target));
+            }
+        }
+    }
+
+    void benchmark_merge_data()
+    {
+        QTest::addColumn<bool>("raw");
+
+        QTest::newRow("recompress") << false;
+        QTest::newRow("raw copy") << true;
+    }
+    void benchmark_merge()
+    {
+        QFETCH(bool, raw);
+        auto target = FS::PathCombine(m_dir.path(), "benchmark.jar");
+
+        QBENCHMARK
+        {
+            QuaZip zipOut(target);
+            QVERIFY(zipOut.open(QuaZip::mdCreate));
+            QSet<QString> added;
+            auto merge = raw ? MMCZip::mergeZipFiles : mergeRecompressing;
+            for (auto i = m_mods.crbegin(); i != m_mods.crend(); i++)
+                QVERIFY(merge(&zipOut, (*i)->fileinfo(), added, nullptr));
+            QVERIFY(merge(&zipOut, QFileInfo(m_clientJar), added, [](const QString& key) { return !key.contains("META-INF"); }));
+            zipOut.close();
+            QCOMPARE(zipOut.getZipError(), 0);
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(MMCZipTest)
+
+#include "MMCZip_test.moc"
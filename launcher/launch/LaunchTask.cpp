@@ -147,18 +147,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_logClassifier = LogClassifier(filter);
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end())
-    {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_logClassifier.censor(in);
 }
 
 void LaunchTask::proceed()
@@ -230,11 +224,16 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
     {
         m_logModel.reset(new LogModel());
         m_logModel->setMaxLines(m_instance->getConsoleMaxLines());
-        m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
-        // FIXME: should this really be here?
-        m_logModel->setOverflowMessage(tr("Stopped watching the game log because the log length surpassed %1 lines.\n"
-            "You may have to fix your mods because the game is still logging to files and"
-            " likely wasting harddrive space at an alarming rate!").arg(m_logModel->getMaxLines()));
+        // keep the whole session around on disk, so none of it has to be dropped and nothing can overflow.
+        // Only without a file for it does the old setting about stopping at the limit still matter.
+        if(!m_logModel->enableHistory(QDir("cache/logs").absolutePath()))
+        {
+            m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
+            // FIXME: should this really be here?
+            m_logModel->setOverflowMessage(tr("Stopped watching the game log because the log length surpassed %1 lines.\n"
+                "You may have to fix your mods because the game is still logging to files and"
+                " likely wasting harddrive space at an alarming rate!").arg(m_logModel->getMaxLines()));
+        }
     }
     return m_logModel;
 }
@@ -256,17 +255,12 @@ void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
         level = innerLevel;
     }
 
-    // If the level is still undetermined, guess level
-    if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
-    {
-        level = m_instance->guessLevel(line, level);
-    }
-
-    // censor private user info
-    line = censorPrivateInfo(line);
+    // If the level is still undetermined, guess level. Also censor private user info, in the same go over the line
+    level = m_logClassifier.process(line, level);
 
+    // lines come in bursts, let the model add them to the views in one go
     auto &model = *getLogModel();
-    model.append(level, line);
+    model.appendLater(level, line);
 }
 
 void LaunchTask::emitSucceeded()
@@ -39,6 +39,7 @@
 #include <QProcess>
 #include <QObjectPtr.h>
 #include "LogModel.h"
+#include "LogClassifier.h"
 #include "BaseInstance.h"
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
@@ -137,7 +138,7 @@ protected: /* data */
     InstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
     QList <shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
+    LogClassifier m_logClassifier;
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
@@ -0,0 +1,366 @@
+#include "LogClassifier.h"
+
+#include <algorithm>
+
+struct LogClassifier::Scan
+{
+    // old forge level markers
+    bool oldInfo = false;
+    bool oldError = false;
+    bool oldWarning = false;
+    bool oldDebug = false;
+
+    bool overwriting = false;
+    bool stackTrace = false;
+
+    // where the level in the first log4j header ("[12:34:56] [main/INFO]") is, if there is one
+    int levelStart = -1;
+    int levelLength = 0;
+};
+
+namespace {
+
+bool isDigit(QChar c)
+{
+    return c.isDigit();
+}
+
+// NOTE: this diverges from the Java spec, no unicode letters
+bool isIdentifierStart(QChar c)
+{
+    auto u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '_' || u == '$';
+}
+
+bool isIdentifierPart(QChar c)
+{
+    return isIdentifierStart(c) || isDigit(c);
+}
+
+// A qualified Java name ("net.minecraft.Foo") starts at `pos`
+bool javaSymbolAt(const QChar* data, int size, int pos)
+{
+    if (pos >= size || !isIdentifierStart(data[pos]))
+        return false;
+    int i = pos + 1;
+    while (i < size && isIdentifierPart(data[i]))
+        i++;
+    return i + 1 < size && data[i] == '.' && isIdentifierStart(data[i + 1]);
+}
+
+// What ends right before `pos` looks like a qualified name ("java.lang.OutOfMemory" before "Error")
+bool qualifiedNameBefore(const QChar* data, int pos)
+{
+    int i = pos;
+    while (i > 0 && isIdentifierPart(data[i - 1]))
+        i--;
+    if (i == 0 || data[i - 1] != '.')
+        return false;
+    // a package name before the dot, anything not starting with a digit will do
+    for (int j = i - 2; j >= 0 && isIdentifierPart(data[j]); j--) {
+        if (isIdentifierStart(data[j]))
+            return true;
+    }
+    return false;
+}
+
+// The line ends like "\t... 12 more"
+bool endsWithMore(const QChar* data, int size)
+{
+    static const char more[] = " more";
+    int end = size;
+    if (end > 0 && data[end - 1] == '\n')
+        end--;
+    int i = end - 5;
+    if (i < 0)
+        return false;
+    for (int j = 0; j < 5; j++) {
+        if (data[i + j] != QLatin1Char(more[j]))
+            return false;
+    }
+    int digits = i;
+    while (digits > 0 && isDigit(data[digits - 1]))
+        digits--;
+    if (digits == i || digits < 4 || data[digits - 1] != ' ')
+        return false;
+    for (int j = digits - 4; j < digits - 1; j++) {
+        if (data[j] == '\n')
+            return false;
+    }
+    return true;
+}
+
+bool equals(const QChar* data, int length, const char* ascii)
+{
+    int i = 0;
+    for (; i < length && ascii[i]; i++) {
+        if (data[i] != QLatin1Char(ascii[i]))
+            return false;
+    }
+    return i == length && !ascii[i];
+}
+
+}  // namespace
+
+LogClassifier::LogClassifier(const QMap<QString, QString>& censor_filter)
+{
+    m_nodes.emplace_back();
+
+    for (auto marker : { "[INFO]", "[CONFIG]", "[FINE]", "[FINER]", "[FINEST]" })
+        addPattern(marker, Kind::OldInfo);
+    for (auto marker : { "[SEVERE]", "[STDERR]" })
+        addPattern(marker, Kind::OldError);
+    addPattern("[WARNING]", Kind::OldWarning);
+    addPattern("[DEBUG]", Kind::OldDebug);
+    addPattern("overwriting existing", Kind::Overwriting);
+    addPattern("Exception in thread", Kind::ExceptionInThread);
+    addPattern("at ", Kind::StackFrame);
+    addPattern("Caused by: ", Kind::CausedBy);
+    for (auto name : { "Exception", "Error", "Throwable" })
+        addPattern(name, Kind::ThrowableName);
+    addPattern("] [", Kind::Log4jHeader);
+
+    for (auto iter = censor_filter.constBegin(); iter != censor_filter.constEnd(); ++iter) {
+        if (iter.key().isEmpty())
+            continue;
+        m_replacements.push_back(iter.value());
+        addPattern(iter.key(), Kind::Secret, int(m_replacements.size()) - 1);
+    }
+
+    compile();
+}
+
+void LogClassifier::addPattern(const QString& text, Kind kind, int replacement)
+{
+    int node = 0;
+    for (auto c : text) {
+        auto& children = m_nodes[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(char16_t(c.unicode()), 0));
+        if (it != children.end() && it->first == c.unicode()) {
+            node = it->second;
+            continue;
+        }
+        int next = int(m_nodes.size());
+        children.insert(it, { char16_t(c.unicode()), next });
+        m_nodes.emplace_back();
+        node = next;
+    }
+
+    // a secret that happens to be one of our markers has to be censored, that's more important than the level
+    if (m_nodes[node].pattern >= 0 && kind != Kind::Secret)
+        return;
+    m_patterns.push_back({ kind, int(text.size()), replacement });
+    m_nodes[node].pattern = int(m_patterns.size()) - 1;
+}
+
+void LogClassifier::compile()
+{
+    std::fill(std::begin(m_rootAscii), std::end(m_rootAscii), -1);
+    for (auto& edge : m_nodes[0].children) {
+        if (edge.first < 128)
+            m_rootAscii[edge.first] = edge.second;
+    }
+
+    // breadth first, so the fail links of shorter prefixes are there when we need them
+    std::vector<int> queue;
+    queue.reserve(m_nodes.size());
+    for (auto& edge : m_nodes[0].children)
+        queue.push_back(edge.second);
+    for (size_t i = 0; i < queue.size(); i++) {
+        int node = queue[i];
+        for (auto& edge : m_nodes[node].children) {
+            auto& next = m_nodes[edge.second];
+            next.fail = step(m_nodes[node].fail, edge.first);
+            auto& fail = m_nodes[next.fail];
+            next.dictLink = fail.pattern >= 0 ? next.fail : fail.dictLink;
+            queue.push_back(edge.second);
+        }
+    }
+}
+
+int LogClassifier::child(int node, char16_t c) const
+{
+    if (node == 0 && c < 128)
+        return m_rootAscii[c];
+    auto& children = m_nodes[node].children;
+    for (auto& edge : children) {
+        if (edge.first == c)
+            return edge.second;
+        if (edge.first > c)
+            break;
+    }
+    return -1;
+}
+
+int LogClassifier::step(int node, char16_t c) const
+{
+    while (true) {
+        int next = child(node, c);
+        if (next >= 0)
+            return next;
+        if (node == 0)
+            return 0;
+        node = m_nodes[node].fail;
+    }
+}
+
+template <typename OnSecret>
+auto LogClassifier::scan(const QString& line, OnSecret on_secret) const -> Scan
+{
+    Scan result;
+    const QChar* data = line.constData();
+    int size = line.size();
+
+    int node = 0;
+    for (int i = 0; i < size; i++) {
+        node = step(node, data[i].unicode());
+        int found = m_nodes[node].pattern >= 0 ? node : m_nodes[node].dictLink;
+        for (; found >= 0; found = m_nodes[found].dictLink) {
+            auto& pattern = m_patterns[m_nodes[found].pattern];
+            int start = i - pattern.length + 1;
+            switch (pattern.kind) {
+                case Kind::OldInfo:
+                    result.oldInfo = true;
+                    break;
+                case Kind::OldError:
+                    result.oldError = true;
+                    break;
+                case Kind::OldWarning:
+                    result.oldWarning = true;
+                    break;
+                case Kind::OldDebug:
+                    result.oldDebug = true;
+                    break;
+                case Kind::Overwriting:
+                    result.overwriting = true;
+                    break;
+                case Kind::ExceptionInThread:
+                    result.stackTrace = true;
+                    break;
+                case Kind::StackFrame:
+                    // "\tat net.minecraft.Foo.bar(Foo.java:12)"
+                    if (!result.stackTrace && start > 0 && data[start - 1].isSpace() && javaSymbolAt(data, size, i + 1))
+                        result.stackTrace = true;
+                    break;
+                case Kind::CausedBy:
+                    if (!result.stackTrace && javaSymbolAt(data, size, i + 1))
+                        result.stackTrace = true;
+                    break;
+                case Kind::ThrowableName:
+                    if (!result.stackTrace && qualifiedNameBefore(data, start))
+                        result.stackTrace = true;
+                    break;
+                case Kind::Log4jHeader: {
+                    // "[12:34:56] [thread/LEVEL]", found by the "] [" in the middle
+                    if (result.levelStart >= 0)
+                        break;
+                    int open = start - 1;
+                    while (open >= 0 && ((data[open].unicode() >= '0' && data[open].unicode() <= '9') || data[open] == ':'))
+                        open--;
+                    if (open == start - 1 || open < 0 || data[open] != '[')
+                        break;
+                    int slash = i + 1;
+                    while (slash < size && data[slash] != '/')
+                        slash++;
+                    if (slash == i + 1 || slash == size)
+                        break;
+                    int close = slash + 1;
+                    while (close < size && data[close] != ']')
+                        close++;
+                    if (close == slash + 1 || close == size)
+                        break;
+                    result.levelStart = slash + 1;
+                    result.levelLength = close - slash - 1;
+                    break;
+                }
+                case Kind::Secret:
+                    on_secret(start, pattern.length, pattern.replacement);
+                    break;
+            }
+        }
+    }
+
+    if (!result.stackTrace && endsWithMore(data, size))
+        result.stackTrace = true;
+    return result;
+}
+
+MessageLevel::Enum LogClassifier::levelFrom(const Scan& scan, const QString& line, MessageLevel::Enum level)
+{
+    if (scan.levelStart >= 0) {
+        // New style logs from log4j
+        auto levelStr = line.constData() + scan.levelStart;
+        auto length = scan.levelLength;
+        if (equals(levelStr, length, "INFO"))
+            level = MessageLevel::Message;
+        else if (equals(levelStr, length, "WARN"))
+            level = MessageLevel::Warning;
+        else if (equals(levelStr, length, "ERROR"))
+            level = MessageLevel::Error;
+        else if (equals(levelStr, length, "FATAL"))
+            level = MessageLevel::Fatal;
+        else if (equals(levelStr, length, "TRACE") || equals(levelStr, length, "DEBUG"))
+            level = MessageLevel::Debug;
+    } else {
+        // Old style forge logs
+        if (scan.oldInfo)
+            level = MessageLevel::Message;
+        if (scan.oldError)
+            level = MessageLevel::Error;
+        if (scan.oldWarning)
+            level = MessageLevel::Warning;
+        if (scan.oldDebug)
+            level = MessageLevel::Debug;
+    }
+    if (scan.overwriting)
+        return MessageLevel::Fatal;
+    if (scan.stackTrace)
+        return MessageLevel::Error;
+    return level;
+}
+
+MessageLevel::Enum LogClassifier::guessLevel(const QString& line, MessageLevel::Enum level) const
+{
+    return levelFrom(scan(line, [](int, int, int) {}), line, level);
+}
+
+QString LogClassifier::replaceMatches(const QString& line)
+{
+    // leftmost first, and the longest of those starting at the same place
+    std::sort(m_matches.begin(), m_matches.end(), [](const Match& a, const Match& b) {
+        return a.start < b.start || (a.start == b.start && a.length > b.length);
+    });
+
+    QString out;
+    out.reserve(line.size());
+    int pos = 0;
+    for (auto& match : m_matches) {
+        if (match.start < pos)
+            continue;
+        out.append(line.constData() + pos, match.start - pos);
+        out.append(m_replacements[match.replacement]);
+        pos = match.start + match.length;
+    }
+    out.append(line.constData() + pos, line.size() - pos);
+    return out;
+}
+
+QString LogClassifier::censor(QString line)
+{
+    process(line, MessageLevel::Launcher);
+    return line;
+}
+
+MessageLevel::Enum LogClassifier::process(QString& line, MessageLevel::Enum level)
+{
+    m_matches.clear();
+    auto result = scan(line, [this](int start, int length, int replacement) { m_matches.push_back({ start, length, replacement }); });
+
+    // only lines we don't know anything about yet need guessing
+    if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown)
+        level = levelFrom(result, line, level);
+
+    if (!m_matches.empty())
+        line = replaceMatches(line);
+    return level;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+#include "MessageLevel.h"
+
+/**
+ * Works out the level of game log lines and censors private info in them.
+ *
+ * Everything it looks for (log4j and old forge level markers, the shapes of Java stack traces and the strings to
+ * censor) is compiled into a single Aho-Corasick automaton when the classifier is made, so each line is looked at
+ * once, without regular expressions and without allocating unless something has to be censored.
+ */
+class LogClassifier
+{
+public:
+    /// `censor_filter` maps the strings to censor to what to replace them with
+    explicit LogClassifier(const QMap<QString, QString>& censor_filter = {});
+
+    /// Guess the level of a line of game log, `level` being what we know about it so far
+    MessageLevel::Enum guessLevel(const QString& line, MessageLevel::Enum level) const;
+
+    /// Replace the strings from the censor filter in `line`
+    QString censor(QString line);
+
+    /// Censor `line` and, unless `level` already tells, guess its level, all in one go over the line
+    MessageLevel::Enum process(QString& line, MessageLevel::Enum level);
+
+private: /* types */
+    enum class Kind
+    {
+        OldInfo,
+        OldError,
+        OldWarning,
+        OldDebug,
+        Overwriting,
+        ExceptionInThread,
+        StackFrame,
+        CausedBy,
+        ThrowableName,
+        Log4jHeader,
+        Secret,
+    };
+
+    struct Pattern
+    {
+        Kind kind;
+        int length;
+        // for secrets, the index into m_replacements
+        int replacement = -1;
+    };
+
+    struct Node
+    {
+        // children sorted by character
+        std::vector<std::pair<char16_t, int>> children;
+        int fail = 0;
+        // longest pattern ending in this node, or -1
+        int pattern = -1;
+        // closest node down the fail chain that ends a pattern, or -1
+        int dictLink = -1;
+    };
+
+    struct Scan;
+
+    struct Match
+    {
+        int start;
+        int length;
+        int replacement;
+    };
+
+private: /* methods */
+    void addPattern(const QString& text, Kind kind, int replacement = -1);
+    void compile();
+    int child(int node, char16_t c) const;
+    int step(int node, char16_t c) const;
+
+    template <typename OnSecret>
+    Scan scan(const QString& line, OnSecret on_secret) const;
+    static MessageLevel::Enum levelFrom(const Scan& scan, const QString& line, MessageLevel::Enum level);
+    QString replaceMatches(const QString& line);
+
+private: /* data */
+    std::vector<Node> m_nodes;
+    std::vector<Pattern> m_patterns;
+    std::vector<QString> m_replacements;
+    // the children of the root for ASCII characters, looked up for most characters of most lines
+    int m_rootAscii[128];
+
+    // reused from line to line
+    std::vector<Match> m_matches;
+};
@@ -0,0 +1,179 @@
+#include <QRegularExpression>
+#include <QTest>
+
+#include "launch/LogClassifier.h"
+
+Q_DECLARE_METATYPE(MessageLevel::Enum)
+
+class LogClassifierTest : public QObject {
+    Q_OBJECT
+
+    // How levels were guessed and info censored before, with a regular expression or a replace for each thing
+    static MessageLevel::Enum regexGuessLevel(const QString& line, MessageLevel::Enum level)
+    {
+        QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+        auto match = re.match(line);
+        if (match.hasMatch()) {
+            QString levelStr = match.captured("level");
+            if (levelStr == "INFO")
+                level = MessageLevel::Message;
+            if (levelStr == "WARN")
+                level = MessageLevel::Warning;
+            if (levelStr == "ERROR")
+                level = MessageLevel::Error;
+            if (levelStr == "FATAL")
+                level = MessageLevel::Fatal;
+            if (levelStr == "TRACE" || levelStr == "DEBUG")
+                level = MessageLevel::Debug;
+        } else {
+            if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
+                line.contains("[FINEST]"))
+                level = MessageLevel::Message;
+            if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
+                level = MessageLevel::Error;
+            if (line.contains("[WARNING]"))
+                level = MessageLevel::Warning;
+            if (line.contains("[DEBUG]"))
+                level = MessageLevel::Debug;
+        }
+        if (line.contains("overwriting existing"))
+            return MessageLevel::Fatal;
+        static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+        if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
+            line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
+            line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
+            line.contains(QRegularExpression("... \\d+ more$")))
+            return MessageLevel::Error;
+        return level;
+    }
+
+    static QString regexCensor(QString line, const QMap<QString, QString>& filter)
+    {
+        for (auto iter = filter.begin(); iter != filter.end(); iter++)
+            line.replace(iter.key(), iter.value());
+        return line;
+    }
+
+    static QMap<QString, QString> censorFilter()
+    {
+        return { { "eyJhbGciOiJIUzI1NiJ9.c2VjcmV0LXRva2Vu.Zm9vYmFy", "<ACCESS TOKEN>" },
+                 { "2ab4c6d8e0f24a6c8e0a2c4e6a8c0e2a", "<PROFILE ID>" } };
+    }
+
+    static QStringList gameLog(int count)
+    {
+        static const char* const templates[] = {
+            "[%1] [main/INFO] [cpw.mods.modlauncher.LaunchServiceHandler/MODLAUNCHER]: Launching target 'forgeclient' with arguments "
+            "[--version, 1.18.2, --accessToken, eyJhbGciOiJIUzI1NiJ9.c2VjcmV0LXRva2Vu.Zm9vYmFy, --uuid, 2ab4c6d8e0f24a6c8e0a2c4e6a8c0e2a]",
+            "[%1] [modloading-worker-0/DEBUG] [net.minecraftforge.registries.ObjectHolderRegistry/REGISTRIES]: Found %2 ObjectHolder annotations",
+            "[%1] [Render thread/WARN] [net.minecraft.client.resources.model.ModelBakery/]: Unable to load model: 'somemod:block/part_%2'",
+            "java.io.FileNotFoundException: somemod:models/block/part_%2.json",
+            "\tat net.minecraft.server.packs.FilePackResources.m_5541_(FilePackResources.java:%2) ~[client-1.18.2-srg.jar%23246!/:?]",
+            "Caused by: java.lang.IllegalStateException: part %2 is missing",
+            "\t... %2 more",
+            "2022-06-01 12:00:00 [INFO] Loading mod number %2 the old way",
+            "Setting user: Player%2",
+            "[%1] [main/INFO] [net.minecraftforge.fml.loading.moddiscovery.ModDiscoverer/SCAN]: Found mod file mod-%2.jar of type MOD",
+        };
+        QStringList lines;
+        lines.reserve(count);
+        for (int i = 0; i < count; i++) {
+            auto time = QString("%1:%2:%3").arg(10 + i / 36000).arg(i / 600 % 60, 2, 10, QChar('0')).arg(i / 10 % 60, 2, 10, QChar('0'));
+            lines.append(QString(templates[i % 10]).arg(time).arg(i));
+        }
+        return lines;
+    }
+
+   private slots:
+    void test_guessLevel_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<MessageLevel::Enum>("level");
+
+        QTest::newRow("log4j info") << "[12:34:56] [main/INFO]: Hello" << MessageLevel::Message;
+        QTest::newRow("log4j warn") << "[12:34:56] [Render thread/WARN] [minecraft/Foo]: Careful" << MessageLevel::Warning;
+        QTest::newRow("log4j trace") << "x [1:2] [a/TRACE] y" << MessageLevel::Debug;
+        QTest::newRow("log4j beats old markers") << "[12:34:56] [main/INFO]: [SEVERE] nope" << MessageLevel::Message;
+        QTest::newRow("unknown log4j level") << "[12:34:56] [main/CHATTY]: Hi" << MessageLevel::StdOut;
+        QTest::newRow("old info") << "2013-01-01 [INFO] Hi" << MessageLevel::Message;
+        QTest::newRow("old debug wins") << "[SEVERE] [WARNING] [DEBUG]" << MessageLevel::Debug;
+        QTest::newRow("overwriting") << "[12:34:56] [main/INFO]: overwriting existing thing" << MessageLevel::Fatal;
+        QTest::newRow("stack frame") << "\tat net.minecraft.client.Main.main(Main.java:42)" << MessageLevel::Error;
+        QTest::newRow("not a stack frame") << "look at this" << MessageLevel::StdOut;
+        QTest::newRow("caused by") << "Caused by: java.lang.NullPointerException" << MessageLevel::Error;
+        QTest::newRow("exception name") << "oops: java.lang.OutOfMemoryError" << MessageLevel::Error;
+        QTest::newRow("no package") << "Error: something" << MessageLevel::StdOut;
+        QTest::newRow("more") << "\t... 23 more" << MessageLevel::Error;
+        QTest::newRow("not quite more") << "\t... 23 more of this" << MessageLevel::StdOut;
+        QTest::newRow("exception in thread") << "Exception in thread \"main\"" << MessageLevel::Error;
+        QTest::newRow("plain") << "Setting user: Player" << MessageLevel::StdOut;
+    }
+    void test_guessLevel()
+    {
+        QFETCH(QString, line);
+        QFETCH(MessageLevel::Enum, level);
+
+        LogClassifier classifier;
+        QCOMPARE(classifier.guessLevel(line, MessageLevel::StdOut), level);
+        QCOMPARE(regexGuessLevel(line, MessageLevel::StdOut), level);
+    }
+
+    void test_sameAsRegex()
+    {
+        LogClassifier classifier(censorFilter());
+        for (auto& line : gameLog(1000)) {
+            auto censored = line;
+            auto level = classifier.process(censored, MessageLevel::StdErr);
+            QCOMPARE(level, regexGuessLevel(line, MessageLevel::StdErr));
+            QCOMPARE(censored, regexCensor(line, censorFilter()));
+        }
+    }
+
+    void test_censor()
+    {
+        LogClassifier classifier({ { "secret", "<SECRET>" }, { "secret-and-more", "<LONGER>" }, { "", "<EMPTY>" } });
+
+        QCOMPARE(classifier.censor("nothing to see"), QString("nothing to see"));
+        QCOMPARE(classifier.censor("secretsecret and secret-and-more"), QString("<SECRET><SECRET> and <LONGER>"));
+
+        // the level of lines we already know about is left alone, but they are still censored
+        QString line = "[12:34:56] [main/ERROR]: secret";
+        QCOMPARE(classifier.process(line, MessageLevel::Launcher), MessageLevel::Launcher);
+        QCOMPARE(line, QString("[12:34:56] [main/ERROR]: <SECRET>"));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_process_data()
+    {
+        QTest::addColumn<bool>("compiled");
+
+        QTest::newRow("regular expressions") << false;
+        QTest::newRow("compiled classifier") << true;
+    }
+    void benchmark_process()
+    {
+        QFETCH(bool, compiled);
+
+        auto log = gameLog(200000);
+        auto filter = censorFilter();
+        LogClassifier classifier(filter);
+
+        QBENCHMARK
+        {
+            for (auto& line : log) {
+                if (compiled) {
+                    auto censored = line;
+                    classifier.process(censored, MessageLevel::StdOut);
+                } else {
+                    regexGuessLevel(line, MessageLevel::StdOut);
+                    regexCensor(line, filter);
+                }
+            }
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LogClassifierTest)
+
+#include "LogClassifier_test.moc"
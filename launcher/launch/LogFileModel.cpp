@@ -0,0 +1,372 @@
+#include "LogFileModel.h"
+
+#include <QByteArrayMatcher>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+
+#include "GZipIndex.h"
+
+// how many lines there are between lines we know the start of, which is also how many lines are read back at once
+static const int s_index_step = 64;
+// how much of the text is searched at once
+static const qint64 s_search_bytes = 4 * 1024 * 1024;
+// how much of a plain file is indexed at once
+static const qint64 s_read_bytes = 1024 * 1024;
+// how often the indexing thread hands over what it has found
+static const qint64 s_update_ms = 100;
+
+namespace {
+// where the lines are, worked out on the indexing thread
+struct LineIndex
+{
+    qint64 size = 0;
+    int lines = 0;
+    // where every 64th line starts
+    QVector<qint64> index = { 0 };
+    // whether the last byte seen was a newline
+    bool endsWithNewline = true;
+
+    void add(const char* data, qint64 length)
+    {
+        auto end = data + length;
+        for (auto newline = data; (newline = static_cast<const char*>(memchr(newline, '\n', end - newline))); newline++) {
+            lines++;
+            if (lines % s_index_step == 0)
+                index.append(size + (newline - data) + 1);
+        }
+        if (length > 0)
+            endsWithNewline = data[length - 1] == '\n';
+        size += length;
+    }
+
+    // the whole text has been seen, so the lines after the last 64th one are known too
+    void finish()
+    {
+        // the last line doesn't need a newline
+        if (size > 0 && !endsWithNewline)
+            lines++;
+        index.resize((lines + s_index_step - 1) / s_index_step);
+        index.append(size);
+    }
+};
+}  // namespace
+
+LogFileModel::LogFileModel(QObject* parent) : QAbstractListModel(parent) {}
+
+LogFileModel::~LogFileModel()
+{
+    stopIndexing();
+}
+
+bool LogFileModel::open(const QString& path)
+{
+    stopIndexing();
+    beginResetModel();
+    m_path.clear();
+    m_gzip.reset();
+    m_page = -1;
+    m_pageLines.clear();
+    m_error.clear();
+    m_size = 0;
+    m_lines = 0;
+    m_index = { 0 };
+
+    // find out whether it can be read right away, anything else comes up while indexing
+    QFile file(path);
+    bool ok = file.open(QFile::ReadOnly);
+    if (ok) {
+        m_path = path;
+        if (path.endsWith(".gz"))
+            m_gzip = std::make_shared<GZipIndex>(path);
+        m_indexing = true;
+        m_thread.reset(QThread::create([this, generation = m_generation, path, gzip = m_gzip] { buildIndex(generation, path, gzip); }));
+        m_thread->start();
+    } else {
+        m_error = file.errorString();
+    }
+    endResetModel();
+    return ok;
+}
+
+void LogFileModel::close()
+{
+    stopIndexing();
+    beginResetModel();
+    m_path.clear();
+    m_gzip.reset();
+    m_page = -1;
+    m_pageLines.clear();
+    m_size = 0;
+    m_lines = 0;
+    m_index = { 0 };
+    endResetModel();
+}
+
+void LogFileModel::stopIndexing()
+{
+    if (m_thread) {
+        m_cancel = true;
+        m_thread->wait();
+        m_thread.reset();
+        m_cancel = false;
+    }
+    m_indexing = false;
+    m_generation++;
+}
+
+void LogFileModel::buildIndex(int generation, const QString& path, std::shared_ptr<GZipIndex> gzip)
+{
+    LineIndex lines;
+    // how many entries of lines.index the model has
+    int handedOver = 1;
+    QElapsedTimer sinceUpdate;
+    sinceUpdate.start();
+
+    // whole pages of lines that can be read back already go to the model every now and then
+    auto update = [&](qint64 done, qint64 total) {
+        if (m_cancel)
+            return false;
+        if (sinceUpdate.elapsed() < s_update_ms)
+            return true;
+        sinceUpdate.restart();
+        qint64 readable = gzip ? gzip->size() : lines.size;
+        int entries = int(std::upper_bound(lines.index.cbegin() + handedOver, lines.index.cend(), readable) - lines.index.cbegin());
+        if (entries > handedOver) {
+            auto added = lines.index.mid(handedOver, entries - handedOver);
+            int count = (entries - 1) * s_index_step;
+            QMetaObject::invokeMethod(
+                this, [this, generation, added, count] { addLines(generation, added, count); }, Qt::QueuedConnection);
+            handedOver = entries;
+        }
+        QMetaObject::invokeMethod(
+            this, [this, generation, done, total] {
+                if (generation == m_generation)
+                    emit indexingProgress(done, total);
+            },
+            Qt::QueuedConnection);
+        return true;
+    };
+
+    bool ok = true;
+    QString error;
+    if (gzip) {
+        ok = gzip->build([&lines](const char* data, qint64 size) { lines.add(data, size); }, update);
+        if (!ok)
+            error = gzip->errorString();
+    } else {
+        QFile file(path);
+        ok = file.open(QFile::ReadOnly);
+        auto total = file.size();
+        QByteArray chunk(int(s_read_bytes), Qt::Uninitialized);
+        qint64 read = 0;
+        while (ok && (read = file.read(chunk.data(), chunk.size())) > 0) {
+            lines.add(chunk.constData(), read);
+            if (!update(lines.size, total))
+                return;
+        }
+        if (!ok || read < 0) {
+            ok = false;
+            error = file.errorString();
+        }
+    }
+    if (m_cancel)
+        return;
+
+    if (ok) {
+        lines.finish();
+        auto added = lines.index.mid(handedOver);
+        int count = lines.lines;
+        QMetaObject::invokeMethod(
+            this, [this, generation, added, count] { addLines(generation, added, count); }, Qt::QueuedConnection);
+    }
+    QMetaObject::invokeMethod(
+        this, [this, generation, ok, error] { finishIndexing(generation, ok, error); }, Qt::QueuedConnection);
+}
+
+void LogFileModel::addLines(int generation, const QVector<qint64>& entries, int lines)
+{
+    if (generation != m_generation)
+        return;
+    // the last entry we have is where the first of the new pages starts
+    int before = m_lines;
+    if (lines > before)
+        beginInsertRows(QModelIndex(), before, lines - 1);
+    m_index += entries;
+    m_size = m_index.last();
+    m_lines = lines;
+    if (lines > before)
+        endInsertRows();
+}
+
+void LogFileModel::finishIndexing(int generation, bool ok, const QString& error)
+{
+    if (generation != m_generation)
+        return;
+    m_indexing = false;
+    if (!ok) {
+        close();
+        m_error = error;
+    }
+    emit indexingFinished(ok);
+}
+
+QString LogFileModel::errorString() const
+{
+    return m_error;
+}
+
+bool LogFileModel::isIndexing() const
+{
+    return m_indexing;
+}
+
+qint64 LogFileModel::size() const
+{
+    return m_size;
+}
+
+QByteArray LogFileModel::readAll() const
+{
+    return read(0, m_size);
+}
+
+QByteArray LogFileModel::read(qint64 offset, qint64 length) const
+{
+    length = std::min(length, m_size - offset);
+    if (offset < 0 || length <= 0)
+        return {};
+    if (m_gzip)
+        return m_gzip->read(offset, length);
+    // opened for every read, so it's never kept from whoever writes the log
+    QFile file(m_path);
+    if (file.open(QFile::ReadOnly) && file.seek(offset))
+        return file.read(length);
+    return {};
+}
+
+int LogFileModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_lines;
+}
+
+QVariant LogFileModel::data(const QModelIndex& index, int role) const
+{
+    if (index.row() < 0 || index.row() >= m_lines)
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return line(index.row());
+    return QVariant();
+}
+
+QString LogFileModel::line(int row) const
+{
+    int page = row / s_index_step;
+    if (m_page != page) {
+        auto data = read(m_index[page], m_index[page + 1] - m_index[page]);
+        int count = std::min(s_index_step, m_lines - page * s_index_step);
+        m_pageLines.clear();
+        m_pageLines.reserve(count);
+        int start = 0;
+        for (int i = 0; i < count; i++) {
+            // it may have been cut short since it was indexed
+            if (start >= data.size()) {
+                m_pageLines.append(QString());
+                continue;
+            }
+            int end = data.indexOf('\n', start);
+            if (end < 0)
+                end = data.size();
+            int length = end - start;
+            if (length > 0 && data.at(end - 1) == '\r')
+                length--;
+            m_pageLines.append(QString::fromUtf8(data.constData() + start, length));
+            start = end + 1;
+        }
+        m_page = page;
+    }
+    return m_pageLines.at(row % s_index_step);
+}
+
+qint64 LogFileModel::lineStart(int row) const
+{
+    if (row >= m_lines)
+        return m_size;
+    int page = row / s_index_step;
+    auto start = m_index[page];
+    auto data = read(start, m_index[page + 1] - start);
+    int pos = 0;
+    for (int i = 0; i < row % s_index_step; i++)
+        pos = data.indexOf('\n', pos) + 1;
+    return start + pos;
+}
+
+int LogFileModel::lineAt(qint64 offset) const
+{
+    auto next = std::upper_bound(m_index.cbegin(), m_index.cend() - 1, offset);
+    int page = int(next - m_index.cbegin()) - 1;
+    auto data = read(m_index[page], offset - m_index[page]);
+    return page * s_index_step + int(std::count(data.cbegin(), data.cend(), '\n'));
+}
+
+int LogFileModel::find(const QString& what, int from, bool reverse) const
+{
+    if (what.isEmpty() || m_lines == 0)
+        return -1;
+    from = ((from % m_lines) + m_lines) % m_lines;
+    if (reverse) {
+        int found = findInRange(what, 0, from, true);
+        // wrap around
+        return found >= 0 ? found : findInRange(what, from + 1, m_lines - 1, true);
+    }
+    int found = findInRange(what, from, m_lines - 1, false);
+    return found >= 0 ? found : findInRange(what, 0, from - 1, false);
+}
+
+int LogFileModel::findInRange(const QString& what, int first, int last, bool reverse) const
+{
+    if (first > last)
+        return -1;
+
+    auto needle = what.toUtf8().toLower();
+    // for plain ASCII we can search the bytes directly, anything else has to be decoded to ignore its case
+    bool ascii = std::all_of(needle.cbegin(), needle.cend(), [](char c) { return uchar(c) < 0x80; });
+    if (!ascii) {
+        for (int n = 0; n <= last - first; n++) {
+            int row = reverse ? last - n : first + n;
+            if (line(row).contains(what, Qt::CaseInsensitive))
+                return row;
+        }
+        return -1;
+    }
+
+    auto start = lineStart(first);
+    auto end = lineStart(last + 1);
+    // chunks overlap by a little less than the needle, so nothing is missed where they meet
+    auto overlap = needle.size() - 1;
+    if (reverse) {
+        while (true) {
+            auto chunkStart = std::max(start, end - s_search_bytes);
+            int pos = read(chunkStart, end - chunkStart).toLower().lastIndexOf(needle);
+            if (pos >= 0)
+                return lineAt(chunkStart + pos);
+            if (chunkStart == start)
+                return -1;
+            end = chunkStart + overlap;
+        }
+    }
+    QByteArrayMatcher matcher(needle);
+    while (true) {
+        auto chunkEnd = std::min(end, start + s_search_bytes);
+        int pos = matcher.indexIn(read(start, chunkEnd - start).toLower());
+        if (pos >= 0)
+            return lineAt(start + pos);
+        if (chunkEnd == end)
+            return -1;
+        start = chunkEnd - overlap;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class GZipIndex;
+
+/**
+ * The lines of a log file on disk, plain or gzipped, without reading it all into memory.
+ *
+ * When a file is opened, a thread of its own goes over it once to find where the lines are, remembering where every
+ * 64th line starts, and builds a GZipIndex on the way for gzipped files. Rows show up as it gets to them. Lines are
+ * read back a page at a time when something asks for them, through a QFile that is only open for that, so the file
+ * isn't held on to: it can be rolled over, truncated or deleted while it's shown, rows read back just come up short.
+ */
+class LogFileModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit LogFileModel(QObject* parent = nullptr);
+    virtual ~LogFileModel();
+
+    /// Start showing the lines of the file at `path`, they come in as it's indexed. If it can't be opened, shows
+    /// nothing and errorString() says why.
+    bool open(const QString& path);
+    /// Stop showing the file and let go of it
+    void close();
+    QString errorString() const;
+    /// Whether the file is still being gone over
+    bool isIndexing() const;
+
+    /// How big the (uncompressed) text shown so far is
+    qint64 size() const;
+    /// All of the text, only sensible for files of a reasonable size
+    QByteArray readAll() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    /// The first row from `from` on (or back from it if `reverse`) containing `what`, ignoring case and wrapping around.
+    /// -1 if there is none.
+    int find(const QString& what, int from, bool reverse) const;
+
+signals:
+    /// `done` out of the `total` bytes of the file have been gone over
+    void indexingProgress(qint64 done, qint64 total);
+    /// The whole file has been gone over, or it turned out it can't be read and errorString() says why
+    void indexingFinished(bool ok);
+
+private:
+    // goes over the file on m_thread
+    void buildIndex(int generation, const QString& path, std::shared_ptr<GZipIndex> gzip);
+    // take the next pages the indexing thread found: `entries` continue m_index, `lines` is how many there are now
+    void addLines(int generation, const QVector<qint64>& entries, int lines);
+    void finishIndexing(int generation, bool ok, const QString& error);
+    void stopIndexing();
+
+    QByteArray read(qint64 offset, qint64 length) const;
+    QString line(int row) const;
+    // where a line starts in the text, `row` can be one past the last line
+    qint64 lineStart(int row) const;
+    // the line that has the byte at `offset`
+    int lineAt(qint64 offset) const;
+    int findInRange(const QString& what, int first, int last, bool reverse) const;
+
+private:
+    QString m_path;
+    std::shared_ptr<GZipIndex> m_gzip;
+    QString m_error;
+
+    std::unique_ptr<QThread> m_thread;
+    std::atomic<bool> m_cancel{ false };
+    // what comes in from an indexing thread that has been stopped since is dropped
+    int m_generation = 0;
+    bool m_indexing = false;
+
+    qint64 m_size = 0;
+    int m_lines = 0;
+    // where every 64th line starts, followed by the size of the text
+    QVector<qint64> m_index = { 0 };
+
+    // the last page of lines read back, views tend to ask for lines next to each other
+    mutable int m_page = -1;
+    mutable QStringList m_pageLines;
+};
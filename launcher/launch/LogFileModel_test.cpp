@@ -0,0 +1,232 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "launch/LogFileModel.h"
+
+class LogFileModelTest : public QObject {
+    Q_OBJECT
+
+    static QStringList modelLines(LogFileModel& model)
+    {
+        QStringList lines;
+        for (int i = 0; i < model.rowCount(); i++)
+            lines.append(model.data(model.index(i), Qt::DisplayRole).toString());
+        return lines;
+    }
+
+    // open it and wait until all of it is there
+    static bool openIndexed(LogFileModel& model, const QString& path)
+    {
+        QSignalSpy finished(&model, &LogFileModel::indexingFinished);
+        if (!model.open(path) || !finished.wait(60 * 1000))
+            return false;
+        return finished.first().first().toBool();
+    }
+
+    static QByteArray numberedLog(int count)
+    {
+        QByteArray log;
+        for (int i = 0; i < count; i++)
+            log.append(QString("[12:00:00] [main/INFO]: line number %1 of the log\n").arg(i).toUtf8());
+        return log;
+    }
+
+   private slots:
+    void test_lines_data()
+    {
+        QTest::addColumn<QByteArray>("contents");
+        QTest::addColumn<QStringList>("lines");
+
+        QTest::newRow("empty") << QByteArray() << QStringList();
+        QTest::newRow("one line") << QByteArray("hello\n") << QStringList({ "hello" });
+        QTest::newRow("no newline at the end") << QByteArray("a\nb") << QStringList({ "a", "b" });
+        QTest::newRow("empty lines") << QByteArray("\n\na\n\n") << QStringList({ "", "", "a", "" });
+        QTest::newRow("windows") << QByteArray("a\r\nb\r\n") << QStringList({ "a", "b" });
+        QTest::newRow("utf-8") << QString("Käse\n日本語\n").toUtf8() << QStringList({ "Käse", "日本語" });
+
+        QStringList many;
+        for (int i = 0; i < 1000; i++)
+            many.append(QString("[12:00:00] [main/INFO]: line number %1 of the log").arg(i));
+        QTest::newRow("many pages") << numberedLog(1000) << many;
+        QTest::newRow("exactly a page") << numberedLog(64) << many.mid(0, 64);
+    }
+    void test_lines()
+    {
+        QFETCH(QByteArray, contents);
+        QFETCH(QStringList, lines);
+
+        QTemporaryDir dir;
+        FS::write(FS::PathCombine(dir.path(), "plain.log"), contents);
+
+        LogFileModel model;
+        QVERIFY(openIndexed(model, FS::PathCombine(dir.path(), "plain.log")));
+        QCOMPARE(modelLines(model), lines);
+        QCOMPARE(model.size(), qint64(contents.size()));
+        QVERIFY(model.readAll() == contents);
+
+        // GZip::zip doesn't make anything out of nothing
+        if (!contents.isEmpty()) {
+            QByteArray compressed;
+            QVERIFY(GZip::zip(contents, compressed));
+            FS::write(FS::PathCombine(dir.path(), "compressed.log.gz"), compressed);
+            QVERIFY(openIndexed(model, FS::PathCombine(dir.path(), "compressed.log.gz")));
+            QCOMPARE(modelLines(model), lines);
+            QVERIFY(model.readAll() == contents);
+        }
+
+        model.close();
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+    void test_find()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.log");
+        FS::write(path, numberedLog(50000) + QString("Ärger im Paradies\n").toUtf8());
+
+        LogFileModel model;
+        QVERIFY(openIndexed(model, path));
+        QCOMPARE(model.rowCount(), 50001);
+
+        QCOMPARE(model.find("NUMBER 4 ", 0, false), 4);
+        QCOMPARE(model.find("number 4 ", 5, false), 4);
+        QCOMPARE(model.find("number 40000 ", 0, false), 40000);
+        QCOMPARE(model.find("number 4", 100, false), 400);
+        QCOMPARE(model.find("number 4", 399, true), 49);
+        QCOMPARE(model.find("number 3", 2, true), 39999);
+        QCOMPARE(model.find("of the log", -2, true), 49999);
+        QCOMPARE(model.find("ärger", 0, false), 50000);
+        QCOMPARE(model.find("ÄRGER", 50000, true), 50000);
+        QCOMPARE(model.find("nowhere", 0, false), -1);
+        QCOMPARE(model.find("", 0, false), -1);
+    }
+
+    void test_missing()
+    {
+        QTemporaryDir dir;
+        LogFileModel model;
+        QVERIFY(!model.open(FS::PathCombine(dir.path(), "missing.log")));
+        QVERIFY(!model.errorString().isEmpty());
+        QCOMPARE(model.rowCount(), 0);
+
+        // that only comes up while indexing
+        FS::write(FS::PathCombine(dir.path(), "broken.log.gz"), "not gzip at all");
+        QVERIFY(!openIndexed(model, FS::PathCombine(dir.path(), "broken.log.gz")));
+        QVERIFY(!model.errorString().isEmpty());
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+    void test_incremental_data()
+    {
+        QTest::addColumn<bool>("compressed");
+
+        QTest::newRow("plain") << false;
+        QTest::newRow("gzip") << true;
+    }
+    void test_incremental()
+    {
+        QFETCH(bool, compressed);
+
+        QTemporaryDir dir;
+        auto log = numberedLog(300000);
+        auto path = FS::PathCombine(dir.path(), compressed ? "big.log.gz" : "big.log");
+        if (compressed) {
+            QByteArray data;
+            QVERIFY(GZip::zip(log, data));
+            FS::write(path, data);
+        } else {
+            FS::write(path, log);
+        }
+
+        LogFileModel model;
+        // rows only ever come in at the end, and every one of them can be read right away
+        int rows = 0;
+        bool readable = true;
+        connect(&model, &QAbstractItemModel::rowsInserted, [&](const QModelIndex&, int first, int last) {
+            readable = readable && first == rows && model.data(model.index(last), Qt::DisplayRole).toString() ==
+                                                        QString("[12:00:00] [main/INFO]: line number %1 of the log").arg(last);
+            rows = last + 1;
+        });
+        QVERIFY(openIndexed(model, path));
+        QVERIFY(readable);
+        QCOMPARE(rows, 300000);
+        QCOMPARE(model.rowCount(), 300000);
+        QVERIFY(!model.isIndexing());
+    }
+
+    void test_reopen()
+    {
+        QTemporaryDir dir;
+        auto big = FS::PathCombine(dir.path(), "big.log");
+        FS::write(big, numberedLog(300000));
+        auto small = FS::PathCombine(dir.path(), "small.log");
+        FS::write(small, "a\nb\n");
+
+        // nothing of the first one makes it into the second
+        LogFileModel model;
+        QVERIFY(model.open(big));
+        QVERIFY(openIndexed(model, small));
+        QCOMPARE(modelLines(model), QStringList({ "a", "b" }));
+        QTest::qWait(200);
+        QCOMPARE(model.rowCount(), 2);
+    }
+
+    void test_truncated()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "latest.log");
+        FS::write(path, numberedLog(1000));
+
+        LogFileModel model;
+        QVERIFY(openIndexed(model, path));
+
+        // the game starting again, it isn't kept from doing that and what's gone just comes up empty
+        FS::write(path, "short\n");
+        QCOMPARE(model.rowCount(), 1000);
+        QCOMPARE(model.data(model.index(0), Qt::DisplayRole).toString(), QString("short"));
+        QCOMPARE(model.data(model.index(1), Qt::DisplayRole).toString(), QString());
+        QCOMPARE(model.data(model.index(999), Qt::DisplayRole).toString(), QString());
+        QCOMPARE(model.find("number", 0, false), -1);
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_open_data()
+    {
+        QTest::addColumn<bool>("compressed");
+
+        QTest::newRow("plain") << false;
+        QTest::newRow("gzip") << true;
+    }
+    void benchmark_open()
+    {
+        QFETCH(bool, compressed);
+
+        QTemporaryDir dir;
+        auto log = numberedLog(2000000);
+        auto path = FS::PathCombine(dir.path(), compressed ? "big.log.gz" : "big.log");
+        if (compressed) {
+            QByteArray data;
+            QVERIFY(GZip::zip(log, data));
+            FS::write(path, data);
+        } else {
+            FS::write(path, log);
+        }
+
+        LogFileModel model;
+        QBENCHMARK
+        {
+            QVERIFY(openIndexed(model, path));
+            // what a view would do right after
+            model.data(model.index(model.rowCount() / 2), Qt::DisplayRole);
+            QCOMPARE(model.find("needle", 0, false), -1);
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LogFileModelTest)
+
+#include "LogFileModel_test.moc"
@@ -0,0 +1,169 @@
+#include "LogHistory.h"
+
+#include <QByteArrayMatcher>
+#include <QDebug>
+
+#include <algorithm>
+
+#include "FileSystem.h"
+
+// how many lines are read back at once for views
+static const int s_page_lines = 256;
+// how many lines are searched at once
+static const int s_search_lines = 16384;
+// how much is buffered before it's written out
+static const int s_write_buffer = 1024 * 1024;
+
+// the line `length` bytes long at `start` in `data`, or what there is of it if the file came up short
+static QString lineIn(const QByteArray& data, qint64 start, qint64 length)
+{
+    start = std::min<qint64>(start, data.size());
+    length = std::max<qint64>(0, std::min<qint64>(length, data.size() - start));
+    return QString::fromUtf8(data.constData() + start, int(length));
+}
+
+LogHistory::LogHistory(const QString& folder)
+{
+    m_offsets.append(0);
+    FS::ensureFolderPathExists(folder);
+    m_file.setFileTemplate(FS::PathCombine(folder, "history-XXXXXX.log"));
+    m_open = m_file.open();
+    if (!m_open)
+        qWarning() << "Couldn't create a file for the game log history:" << m_file.errorString();
+}
+
+bool LogHistory::isOpen() const
+{
+    return m_open;
+}
+
+void LogHistory::append(MessageLevel::Enum level, const QString& line)
+{
+    auto data = line.toUtf8();
+    m_offsets.append(m_offsets.last() + data.size() + 1);
+    m_levels.append(char(level));
+    if (!m_open)
+        return;
+
+    m_unwritten.append(data);
+    m_unwritten.append('\n');
+    if (m_unwritten.size() >= s_write_buffer)
+        flushWrites();
+}
+
+void LogHistory::clear()
+{
+    m_offsets.clear();
+    m_offsets.append(0);
+    m_levels.clear();
+    m_unwritten.clear();
+    m_pageFirst = -1;
+    m_page.clear();
+    if (m_open)
+        m_file.resize(0);
+}
+
+MessageLevel::Enum LogHistory::level(int index) const
+{
+    if (index < 0 || index >= size())
+        return MessageLevel::Unknown;
+    return MessageLevel::Enum(m_levels.at(index));
+}
+
+QString LogHistory::line(int index)
+{
+    if (index < 0 || index >= size())
+        return {};
+
+    if (m_pageFirst < 0 || index < m_pageFirst || index >= m_pageFirst + m_page.size()) {
+        m_pageFirst = index - index % s_page_lines;
+        int last = std::min(size(), m_pageFirst + s_page_lines);
+        auto data = read(m_pageFirst, last);
+        auto base = m_offsets[m_pageFirst];
+
+        m_page.clear();
+        m_page.reserve(last - m_pageFirst);
+        for (int i = m_pageFirst; i < last; i++)
+            m_page.append(lineIn(data, m_offsets[i] - base, m_offsets[i + 1] - m_offsets[i] - 1));
+    }
+    return m_page.at(index - m_pageFirst);
+}
+
+int LogHistory::find(const QString& what, int from, bool reverse)
+{
+    if (from < 0 || from >= size())
+        return -1;
+    return reverse ? findInRange(what, 0, from, true) : findInRange(what, from, size() - 1, false);
+}
+
+int LogHistory::findInRange(const QString& what, int first, int last, bool reverse)
+{
+    if (what.isEmpty() || first < 0 || last >= size() || first > last)
+        return -1;
+
+    auto needle = what.toUtf8().toLower();
+    // for plain ASCII we can search the bytes directly, anything else has to be decoded to ignore its case
+    bool ascii = std::all_of(needle.cbegin(), needle.cend(), [](char c) { return uchar(c) < 0x80; });
+    QByteArrayMatcher matcher(needle);
+
+    auto search = [&](int begin, int end) -> int {
+        auto data = read(begin, end);
+        if (ascii) {
+            data = data.toLower();
+            int pos = reverse ? data.lastIndexOf(needle) : matcher.indexIn(data);
+            return pos < 0 ? -1 : lineAt(m_offsets[begin] + pos);
+        }
+        auto base = m_offsets[begin];
+        for (int n = 0; n < end - begin; n++) {
+            int i = reverse ? end - 1 - n : begin + n;
+            auto line = lineIn(data, m_offsets[i] - base, m_offsets[i + 1] - m_offsets[i] - 1);
+            if (line.contains(what, Qt::CaseInsensitive))
+                return i;
+        }
+        return -1;
+    };
+
+    if (reverse) {
+        for (int end = last + 1; end > first; end -= s_search_lines) {
+            int found = search(std::max(first, end - s_search_lines), end);
+            if (found >= 0)
+                return found;
+        }
+    } else {
+        for (int begin = first; begin <= last; begin += s_search_lines) {
+            int found = search(begin, std::min(last + 1, begin + s_search_lines));
+            if (found >= 0)
+                return found;
+        }
+    }
+    return -1;
+}
+
+void LogHistory::flushWrites()
+{
+    if (m_unwritten.isEmpty() || !m_open)
+        return;
+    m_file.seek(m_file.size());
+    if (m_file.write(m_unwritten) != m_unwritten.size()) {
+        // a full disk most likely, what's in the file from now on doesn't match the offsets anymore
+        qWarning() << "Failed to write to the game log history, not keeping it anymore:" << m_file.errorString();
+        m_open = false;
+    }
+    m_unwritten.clear();
+}
+
+QByteArray LogHistory::read(int first, int last)
+{
+    flushWrites();
+    if (!m_file.isOpen())
+        return {};
+    auto start = m_offsets[first];
+    m_file.seek(start);
+    return m_file.read(m_offsets[last] - start);
+}
+
+int LogHistory::lineAt(qint64 offset) const
+{
+    auto next = std::upper_bound(m_offsets.cbegin(), m_offsets.cend(), offset);
+    return int(next - m_offsets.cbegin()) - 1;
+}
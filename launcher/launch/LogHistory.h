@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "MessageLevel.h"
+
+/**
+ * All the lines a game logged this session, kept in an append-only file on disk instead of in memory.
+ * That file is in the folder it's given, not the system's temporary folder, which is often in memory itself.
+ *
+ * Only an index of where each line starts in the file and the level of each line are kept in memory, a few bytes per
+ * line. Lines are read back a page at a time, and searches go over the file in big sequential chunks, so they stay
+ * fast at millions of lines.
+ */
+class LogHistory
+{
+public:
+    /// Keep the file in `folder`
+    explicit LogHistory(const QString& folder);
+
+    /// Whether we got a file to write to and writing to it still works. If it doesn't, lines are still counted, but
+    /// those that didn't make it to the file come back empty.
+    bool isOpen() const;
+
+    void append(MessageLevel::Enum level, const QString& line);
+    void clear();
+
+    int size() const { return m_levels.size(); }
+    MessageLevel::Enum level(int index) const;
+    QString line(int index);
+
+    /// The first line starting from `from` (going back if `reverse`) that contains `what`, ignoring case. -1 if there is none.
+    int find(const QString& what, int from, bool reverse);
+    /// Same as find(), but only in the lines `first` up to `last` (included)
+    int findInRange(const QString& what, int first, int last, bool reverse);
+
+private:
+    void flushWrites();
+    // the contents of lines `first` up to `last` (excluded), newlines and all
+    QByteArray read(int first, int last);
+    // the line that has the byte at `offset` in the file
+    int lineAt(qint64 offset) const;
+
+private:
+    QTemporaryFile m_file;
+    bool m_open = false;
+
+    // where each line starts in the file, followed by where the next one will
+    QVector<qint64> m_offsets;
+    // the level of each line, one byte each
+    QByteArray m_levels;
+    // appended lines that still need to be written
+    QByteArray m_unwritten;
+
+    // the last page of lines read back, views tend to ask for lines next to each other
+    int m_pageFirst = -1;
+    QStringList m_page;
+};
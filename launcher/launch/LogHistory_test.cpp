@@ -0,0 +1,94 @@
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "launch/LogHistory.h"
+
+class LogHistoryTest : public QObject {
+    Q_OBJECT
+
+    static QString numberedLine(int i) { return QString("[12:00:00] [main/INFO]: line number %1 of the log").arg(i); }
+
+   private slots:
+    void test_roundtrip()
+    {
+        QTemporaryDir dir;
+        LogHistory history(dir.path());
+        QVERIFY(history.isOpen());
+        // in the folder it was given, not wherever temporary files go
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+
+        // more than a page and more than the write buffer, so both get exercised
+        for (int i = 0; i < 30000; i++)
+            history.append(i % 3 ? MessageLevel::Message : MessageLevel::Error, numberedLine(i));
+        history.append(MessageLevel::Warning, QString::fromUtf8("Käse, 日本語 and an emoji 😀"));
+        history.append(MessageLevel::Message, "");
+
+        QCOMPARE(history.size(), 30002);
+        for (int i : { 0, 1, 255, 256, 12345, 29999, 0 }) {
+            QCOMPARE(history.line(i), numberedLine(i));
+            QCOMPARE(history.level(i), i % 3 ? MessageLevel::Message : MessageLevel::Error);
+        }
+        QCOMPARE(history.line(30000), QString::fromUtf8("Käse, 日本語 and an emoji 😀"));
+        QCOMPARE(history.level(30000), MessageLevel::Warning);
+        QCOMPARE(history.line(30001), QString());
+        QCOMPARE(history.line(30002), QString());
+
+        history.clear();
+        QCOMPARE(history.size(), 0);
+        history.append(MessageLevel::Message, "again");
+        QCOMPARE(history.line(0), QString("again"));
+    }
+
+    void test_find()
+    {
+        QTemporaryDir dir;
+        LogHistory history(dir.path());
+        for (int i = 0; i < 50000; i++)
+            history.append(MessageLevel::Message, numberedLine(i));
+        history.append(MessageLevel::Message, QString::fromUtf8("Ärger im Paradies"));
+
+        QCOMPARE(history.find("NUMBER 4 ", 0, false), 4);
+        QCOMPARE(history.find("number 4 ", 5, false), -1);
+        QCOMPARE(history.find("number 40000 ", 0, false), 40000);
+        QCOMPARE(history.find("number 4", 100, false), 400);
+        QCOMPARE(history.find("number 4", 399, true), 49);
+        QCOMPARE(history.find("number 3", 2, true), -1);
+        QCOMPARE(history.find("of the log", 49999, true), 49999);
+        QCOMPARE(history.find("ärger", 0, false), 50000);
+        QCOMPARE(history.find(QString::fromUtf8("ÄRGER"), 50000, true), 50000);
+        QCOMPARE(history.find("nowhere", 0, false), -1);
+        QCOMPARE(history.find("", 0, false), -1);
+
+        QCOMPARE(history.findInRange("number 4", 5, 49, false), 40);
+        QCOMPARE(history.findInRange("number 4", 0, 39, true), 4);
+        QCOMPARE(history.findInRange("number 4", 5, 39, false), -1);
+        QCOMPARE(history.findInRange("number 4", 5, 39, true), -1);
+        // more than one chunk
+        QCOMPARE(history.findInRange("number 4", 401, 39999, false), 401);
+        QCOMPARE(history.findInRange("number 4", 50, 40000, true), 40000);
+        QCOMPARE(history.findInRange("number 4", 50, 399, true), -1);
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_find()
+    {
+        QTemporaryDir dir;
+        LogHistory history(dir.path());
+        const int count = 1000000;
+        for (int i = 0; i < count; i++)
+            history.append(MessageLevel::Message, numberedLine(i));
+
+        int found = -1;
+        QBENCHMARK
+        {
+            found = history.find("needle", 0, false);
+        }
+        QCOMPARE(found, -1);
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LogHistoryTest)
+
+#include "LogHistory_test.moc"
@@ -1,5 +1,10 @@
 #include "LogModel.h"
 
+#include <QDebug>
+
+// how many of the latest lines stay in memory with the history, everything else is read back from it
+static const int s_history_window = 1000;
+
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
     m_content.resize(m_maxLines);
@@ -10,16 +15,31 @@ int LogModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return m_numLines;
+    return m_history ? m_history->size() : m_numLines;
 }
 
 QVariant LogModel::data(const QModelIndex &index, int role) const
 {
-    if (index.row() < 0 || index.row() >= m_numLines)
+    auto row = index.row();
+    if (row < 0 || row >= rowCount())
         return QVariant();
 
-    auto row = index.row();
-    auto realRow = (row + m_firstLine) % m_maxLines;
+    // rows before the ones in memory come from the history
+    int firstInMemory = rowCount() - m_numLines;
+    if (row < firstInMemory)
+    {
+        if (role == Qt::DisplayRole || role == Qt::EditRole)
+        {
+            return m_history->line(row);
+        }
+        if(role == LevelRole)
+        {
+            return m_history->level(row);
+        }
+        return QVariant();
+    }
+
+    auto realRow = (row - firstInMemory + m_firstLine) % m_maxLines;
     if (role == Qt::DisplayRole || role == Qt::EditRole)
     {
         return m_content[realRow].line;
@@ -34,36 +54,124 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 
 void LogModel::append(MessageLevel::Enum level, QString line)
 {
-    if(m_suspended)
+    // keep the lines in order
+    flush();
+    append(QVector<entry>{ { level, std::move(line) } });
+}
+
+void LogModel::append(QVector<entry> lines)
+{
+    if(m_suspended || lines.isEmpty() || m_maxLines <= 0)
+    {
+        return;
+    }
+    if(m_history)
     {
+        // nothing is lost, the oldest lines only leave memory
+        int total = m_history->size();
+        beginInsertRows(QModelIndex(), total, total + lines.size() - 1);
+        for(auto & line: lines)
+        {
+            m_history->append(line.level, line.line);
+            if(m_numLines == m_maxLines)
+            {
+                m_firstLine = (m_firstLine + 1) % m_maxLines;
+                m_numLines --;
+            }
+            m_content[(m_firstLine + m_numLines) % m_maxLines] = std::move(line);
+            m_numLines ++;
+        }
+        endInsertRows();
+        if(!m_history->isOpen())
+        {
+            dropHistory();
+        }
         return;
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-    // overflow
-    if(m_numLines == m_maxLines)
+    if(m_stopOnOverflow)
     {
-        if(m_stopOnOverflow)
+        int space = m_maxLines - m_numLines;
+        if(space <= 0)
         {
             // nothing more to do, the buffer is full
             return;
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
-        m_firstLine = (m_firstLine + 1) % m_maxLines;
-        m_numLines --;
+        // the last line that fits tells the user we stopped here
+        if(lines.size() >= space)
+        {
+            lines.resize(space);
+            lines.last() = { MessageLevel::Fatal, m_overflowMessage };
+        }
+    }
+    else if(lines.size() > m_maxLines)
+    {
+        // these would be pushed out right away
+        lines.erase(lines.begin(), lines.end() - m_maxLines);
+    }
+
+    int count = lines.size();
+    // overflow, make room by dropping the oldest lines
+    int overflow = m_numLines + count - m_maxLines;
+    if(overflow > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_firstLine = (m_firstLine + overflow) % m_maxLines;
+        m_numLines -= overflow;
         endRemoveRows();
     }
-    else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for(auto & line: lines)
     {
-        level = MessageLevel::Fatal;
-        line = m_overflowMessage;
+        m_content[(m_firstLine + m_numLines) % m_maxLines] = std::move(line);
+        m_numLines ++;
     }
-    beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines ++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
     endInsertRows();
 }
 
+void LogModel::appendLater(MessageLevel::Enum level, QString line)
+{
+    if(m_suspended)
+    {
+        return;
+    }
+    if(m_history)
+    {
+        // everything is kept
+    }
+    else if(m_stopOnOverflow)
+    {
+        // anything past this won't fit anyway
+        if(m_numLines + m_pending.size() >= m_maxLines)
+        {
+            return;
+        }
+    }
+    else if(m_pending.size() >= 2 * m_maxLines)
+    {
+        // only the newest lines would survive, drop the older ones in bulk
+        m_pending.erase(m_pending.begin(), m_pending.end() - m_maxLines);
+    }
+    m_pending.append({ level, std::move(line) });
+
+    if(!m_flushScheduled)
+    {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, &LogModel::flush, Qt::QueuedConnection);
+    }
+}
+
+void LogModel::flush()
+{
+    m_flushScheduled = false;
+    if(m_pending.isEmpty())
+    {
+        return;
+    }
+    QVector<entry> lines;
+    lines.swap(m_pending);
+    append(std::move(lines));
+}
+
 void LogModel::suspend(bool suspend)
 {
     m_suspended = suspend;
@@ -76,7 +184,12 @@ bool LogModel::suspended()
 
 void LogModel::clear()
 {
+    m_pending.clear();
     beginResetModel();
+    if(m_history)
+    {
+        m_history->clear();
+    }
     m_firstLine = 0;
     m_numLines = 0;
     endResetModel();
@@ -84,7 +197,16 @@ void LogModel::clear()
 
 QString LogModel::toPlainText()
 {
+    flush();
     QString out;
+    if(m_history)
+    {
+        for(int i = 0; i < m_history->size(); i++)
+        {
+            out.append(m_history->line(i) + '\n');
+        }
+        return out;
+    }
     out.reserve(m_numLines * 80);
     for(int i = 0; i < m_numLines; i++)
     {
@@ -97,19 +219,26 @@ QString LogModel::toPlainText()
 
 void LogModel::setMaxLines(int maxLines)
 {
+    flush();
     // no-op
     if(maxLines == m_maxLines)
     {
         return;
     }
-    // if it all still fits in the buffer, just resize it
-    if(m_firstLine + m_numLines < m_maxLines)
+    // with the history, the window in memory stays as it is, this only matters if the history goes away
+    if(m_history)
+    {
+        m_maxLinesWithoutHistory = maxLines;
+        return;
+    }
+    // if it doesn't wrap and stays where it is in the new size too, just resize it
+    if(m_firstLine + m_numLines <= std::min(m_maxLines, maxLines))
     {
         m_maxLines = maxLines;
         m_content.resize(maxLines);
         return;
     }
-    // otherwise, we need to reorganize the data because it crosses the wrap boundary
+    // otherwise, we need to reorganize the data because it crosses the wrap boundary or is cut by the new size
     QVector<entry> newContent;
     newContent.resize(maxLines);
     if(m_numLines <= maxLines)
@@ -130,7 +259,7 @@ void LogModel::setMaxLines(int maxLines)
         {
             newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
         }
-        m_numLines = m_maxLines;
+        m_numLines = maxLines;
         m_content.swap(newContent);
         endRemoveRows();
     }
@@ -138,9 +267,87 @@ void LogModel::setMaxLines(int maxLines)
     m_maxLines = maxLines;
 }
 
+bool LogModel::enableHistory(const QString & folder)
+{
+    if(m_history)
+    {
+        return true;
+    }
+    auto history = std::make_unique<LogHistory>(folder);
+    if(!history->isOpen())
+    {
+        return false;
+    }
+    // what we have so far is the start of it
+    flush();
+    for(int i = 0; i < m_numLines; i++)
+    {
+        auto & line = m_content[(m_firstLine + i) % m_maxLines];
+        history->append(line.level, line.line);
+    }
+    m_history = std::move(history);
+    m_maxLinesWithoutHistory = m_maxLines;
+    resizeBuffer(s_history_window);
+    return true;
+}
+
+void LogModel::dropHistory()
+{
+    qWarning() << "Couldn't write the game log history anymore, only keeping the latest" << m_maxLinesWithoutHistory << "lines";
+    beginResetModel();
+    m_history.reset();
+    resizeBuffer(m_maxLinesWithoutHistory);
+    endResetModel();
+}
+
+void LogModel::resizeBuffer(int lines)
+{
+    QVector<entry> newContent;
+    newContent.resize(lines);
+    int keep = std::min(m_numLines, lines);
+    for(int i = 0; i < keep; i++)
+    {
+        newContent[i] = m_content[(m_firstLine + m_numLines - keep + i) % m_maxLines];
+    }
+    m_content.swap(newContent);
+    m_firstLine = 0;
+    m_numLines = keep;
+    m_maxLines = lines;
+}
+
+int LogModel::find(const QString& what, int from, bool reverse)
+{
+    flush();
+    int rows = rowCount();
+    if(what.isEmpty() || rows == 0)
+    {
+        return -1;
+    }
+    from = ((from % rows) + rows) % rows;
+    if(m_history)
+    {
+        int found = m_history->find(what, from, reverse);
+        if(found < 0)
+        {
+            // wrap around, up to where we started
+            found = reverse ? m_history->findInRange(what, from + 1, rows - 1, true) : m_history->findInRange(what, 0, from - 1, false);
+        }
+        return found;
+    }
+    for(int n = 0; n < rows; n++)
+    {
+        int row = reverse ? (from - n + rows) % rows : (from + n) % rows;
+        if(m_content[(m_firstLine + row) % m_maxLines].line.contains(what, Qt::CaseInsensitive))
+        {
+            return row;
+        }
+    }
+    return -1;
+}
+
 int LogModel::getMaxLines()
 {
-    return m_maxLines;
+    return m_history ? m_maxLinesWithoutHistory : m_maxLines;
 }
 
 void LogModel::setStopOnOverflow(bool stop)
@@ -2,11 +2,23 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QVector>
+
+#include <memory>
+
+#include "LogHistory.h"
 #include "MessageLevel.h"
 
 class LogModel : public QAbstractListModel
 {
     Q_OBJECT
+public: /* types */
+    struct entry
+    {
+        MessageLevel::Enum level;
+        QString line;
+    };
+
 public:
     explicit LogModel(QObject *parent = 0);
 
@@ -14,11 +26,16 @@ public:
     QVariant data(const QModelIndex &index, int role) const;
 
     void append(MessageLevel::Enum, QString line);
+    /// Add all the lines at once, telling views about it only once
+    void append(QVector<entry> lines);
+    /// Queue the line up, to be added along with everything else queued before we get back to the event loop
+    void appendLater(MessageLevel::Enum level, QString line);
     void clear();
 
     void suspend(bool suspend);
     bool suspended();
 
+    /// All the lines, the whole session with the history
     QString toPlainText();
 
     int getMaxLines();
@@ -29,21 +46,34 @@ public:
     void setLineWrap(bool state);
     bool wrapLines() const;
 
+    /// Keep every line in a file in `folder`, making the lines in memory a small window over the latest ones.
+    /// Nothing is dropped and logging never stops after that, unless writing the file fails: then only the latest
+    /// getMaxLines() lines are kept from there on. Returns false if we couldn't get a file.
+    bool enableHistory(const QString & folder);
+    /// The first row from `from` on (or back from it if `reverse`) containing `what`, ignoring case and wrapping around.
+    /// -1 if there is none.
+    int find(const QString & what, int from, bool reverse);
+
     enum Roles
     {
         LevelRole = Qt::UserRole
     };
 
-private /* types */:
-    struct entry
-    {
-        MessageLevel::Enum level;
-        QString line;
-    };
+public slots:
+    /// Add the lines queued by appendLater() right away
+    void flush();
+
+private:
+    // make room for `lines` lines in memory, keeping the latest ones of those there are
+    void resizeBuffer(int lines);
+    // go back to keeping only what's in memory, when the history can't be written anymore
+    void dropHistory();
 
 private: /* data */
     QVector <entry> m_content;
     int m_maxLines = 1000;
+    // with the history, m_maxLines is only the window in memory and this is what setMaxLines() asked for
+    int m_maxLinesWithoutHistory = 1000;
     // first line in the circular buffer
     int m_firstLine = 0;
     // number of lines occupied in the circular buffer
@@ -52,6 +82,11 @@ private: /* data */
     QString m_overflowMessage = "OVERFLOW";
     bool m_suspended = false;
     bool m_lineWrap = true;
+    // lines from appendLater() that still need to be added
+    QVector<entry> m_pending;
+    bool m_flushScheduled = false;
+    // everything logged so far, if we keep it
+    std::unique_ptr<LogHistory> m_history;
 
 private:
     Q_DISABLE_COPY(LogModel)
@@ -0,0 +1,219 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "launch/LogModel.h"
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+    static QStringList modelLines(LogModel& model)
+    {
+        QStringList lines;
+        for (int i = 0; i < model.rowCount(); i++)
+            lines.append(model.data(model.index(i), Qt::DisplayRole).toString());
+        return lines;
+    }
+
+    static QVector<LogModel::entry> numberedLines(int first, int count)
+    {
+        QVector<LogModel::entry> lines;
+        for (int i = first; i < first + count; i++)
+            lines.append({ MessageLevel::Info, QString::number(i) });
+        return lines;
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    // Something like what a modded client prints while it starts up
+    static QStringList forgeStartupLog(int count)
+    {
+        static const char* const templates[] = {
+            "[%1] [main/INFO] [cpw.mods.modlauncher.LaunchServiceHandler/MODLAUNCHER]: Launching target 'forgeclient' with arguments [--version, "
+            "1.18.2, --gameDir, /home/user/.local/share/PolyMC/instances/pack/.minecraft]",
+            "[%1] [modloading-worker-0/DEBUG] [net.minecraftforge.registries.ObjectHolderRegistry/REGISTRIES]: Found %2 ObjectHolder annotations",
+            "[%1] [Render thread/WARN] [net.minecraft.client.resources.model.ModelBakery/]: Unable to load model: 'somemod:block/part_%2' "
+            "referenced from: somemod:part#facing=north: java.io.FileNotFoundException: somemod:models/block/part_%2.json",
+            "\tat net.minecraft.server.packs.FilePackResources.m_5541_(FilePackResources.java:%2) ~[client-1.18.2-20220404.173914-srg.jar%23246!/:?]",
+            "[%1] [main/INFO] [net.minecraftforge.fml.loading.moddiscovery.ModDiscoverer/SCAN]: Found mod file mod-%2.jar of type MOD with "
+            "provider {mods folder locator at /home/user/.local/share/PolyMC/instances/pack/.minecraft/mods}",
+        };
+        QStringList lines;
+        lines.reserve(count);
+        for (int i = 0; i < count; i++) {
+            auto time = QString("%1:%2:%3").arg(10 + i / 36000).arg(i / 600 % 60, 2, 10, QChar('0')).arg(i / 10 % 60, 2, 10, QChar('0'));
+            lines.append(QString(templates[i % 5]).arg(time).arg(i));
+        }
+        return lines;
+    }
+#endif
+
+   private slots:
+    void test_batchMatchesSingleLines_data()
+    {
+        QTest::addColumn<int>("maxLines");
+        QTest::addColumn<bool>("stopOnOverflow");
+        QTest::addColumn<int>("batchSize");
+
+        QTest::newRow("fits") << 100 << false << 7;
+        QTest::newRow("wraps around") << 10 << false << 3;
+        QTest::newRow("batch bigger than the buffer") << 10 << false << 25;
+        QTest::newRow("stops") << 10 << true << 3;
+        QTest::newRow("stops in a big batch") << 10 << true << 25;
+    }
+    void test_batchMatchesSingleLines()
+    {
+        QFETCH(int, maxLines);
+        QFETCH(bool, stopOnOverflow);
+        QFETCH(int, batchSize);
+
+        LogModel single;
+        LogModel batched;
+        for (auto model : { &single, &batched }) {
+            model->setMaxLines(maxLines);
+            model->setStopOnOverflow(stopOnOverflow);
+            model->setOverflowMessage("overflow");
+        }
+
+        int total = 0;
+        for (int first = 0; first < 60; first += batchSize) {
+            auto lines = numberedLines(first, batchSize);
+            total += lines.size();
+            for (auto& line : lines)
+                single.append(line.level, line.line);
+            batched.append(lines);
+            QCOMPARE(modelLines(batched), modelLines(single));
+        }
+        QCOMPARE(batched.rowCount(), std::min(maxLines, total));
+    }
+
+    void test_appendLater()
+    {
+        LogModel model;
+        model.setMaxLines(100);
+        QSignalSpy inserted(&model, &LogModel::rowsInserted);
+        QSignalSpy removed(&model, &LogModel::rowsRemoved);
+
+        for (auto& line : numberedLines(0, 150))
+            model.appendLater(line.level, line.line);
+        QCOMPARE(model.rowCount(), 0);
+
+        // the whole burst lands in one go
+        QCoreApplication::processEvents();
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(removed.count(), 0);
+        QCOMPARE(model.rowCount(), 100);
+        QCOMPARE(modelLines(model).first(), QString("50"));
+
+        // lines added directly stay in order with the queued ones
+        model.appendLater(MessageLevel::Info, "queued");
+        model.append(MessageLevel::Info, "direct");
+        QCOMPARE(modelLines(model).mid(98), QStringList({ "queued", "direct" }));
+        QCOMPARE(removed.count(), 2);
+    }
+
+    void test_shrink()
+    {
+        // not wrapped around yet, but more lines than the new size
+        LogModel model;
+        model.setMaxLines(100);
+        model.append(numberedLines(0, 50));
+        QSignalSpy removed(&model, &LogModel::rowsRemoved);
+
+        model.setMaxLines(20);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(model.rowCount(), 20);
+        QCOMPARE(modelLines(model).first(), QString("30"));
+        QCOMPARE(modelLines(model).last(), QString("49"));
+
+        model.append(MessageLevel::Info, "new");
+        QCOMPARE(model.rowCount(), 20);
+        QCOMPARE(modelLines(model).last(), QString("new"));
+    }
+
+    void test_history()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        model.setStopOnOverflow(true);
+        model.append(MessageLevel::Error, "before");
+        QTemporaryDir dir;
+        QVERIFY(model.enableHistory(dir.path()));
+        QSignalSpy removed(&model, &LogModel::rowsRemoved);
+
+        model.append(numberedLines(0, 25));
+        for (auto& line : numberedLines(25, 25))
+            model.append(line.level, line.line);
+
+        // nothing is dropped or stopped, only kept out of memory
+        QCOMPARE(removed.count(), 0);
+        QCOMPARE(model.rowCount(), 51);
+        auto lines = modelLines(model);
+        QCOMPARE(lines.first(), QString("before"));
+        QCOMPARE(lines.last(), QString("49"));
+        QCOMPARE(lines.mid(1), [] {
+            QStringList expected;
+            for (int i = 0; i < 50; i++)
+                expected.append(QString::number(i));
+            return expected;
+        }());
+        QCOMPARE(model.data(model.index(0), LogModel::LevelRole).toInt(), int(MessageLevel::Error));
+        // copied and uploaded as a whole
+        QCOMPARE(model.toPlainText().count('\n'), 51);
+        QVERIFY(model.toPlainText().startsWith("before\n0\n1\n"));
+
+        QCOMPARE(model.find("BEFORE", 10, false), 0);
+        QCOMPARE(model.find("3", 30, true), 24);
+        QCOMPARE(model.find("49", 51, false), 50);
+
+        model.setMaxLines(5);
+        QCOMPARE(modelLines(model), lines);
+
+        model.clear();
+        QCOMPARE(model.rowCount(), 0);
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_forgeStartup_data()
+    {
+        QTest::addColumn<bool>("coalesced");
+
+        QTest::newRow("line by line") << false;
+        QTest::newRow("coalesced") << true;
+    }
+    void benchmark_forgeStartup()
+    {
+        QFETCH(bool, coalesced);
+
+        auto log = forgeStartupLog(200000);
+        // about what one read of a busy stdout pipe gives us
+        const int linesPerRead = 400;
+
+        QBENCHMARK
+        {
+            LogModel model;
+            model.setMaxLines(100000);
+            // something has to look at the new lines, like the view would
+            int seen = 0;
+            connect(&model, &LogModel::rowsInserted, [&](const QModelIndex&, int first, int last) {
+                for (int i = first; i <= last; i++)
+                    seen += model.data(model.index(i), Qt::DisplayRole).toString().size() > 0;
+            });
+
+            for (int read = 0; read < log.size(); read += linesPerRead) {
+                for (int i = read; i < std::min(read + linesPerRead, int(log.size())); i++) {
+                    if (coalesced)
+                        model.appendLater(MessageLevel::Info, log[i]);
+                    else
+                        model.append(MessageLevel::Info, log[i]);
+                }
+                QCoreApplication::processEvents();
+            }
+            QVERIFY(seen == log.size());
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
@@ -0,0 +1,146 @@
+#include "AssetsLedger.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "AssetsUtils.h"
+#include "FileSystem.h"
+
+static const quint32 s_ledger_magic = 0x4c454447;  // "LEDG"
+static const quint32 s_ledger_version = 1;
+
+static QByteArray hashKey(const AssetObject &object)
+{
+    return QByteArray(reinterpret_cast<const char *>(object.hash.data()), int(object.hash.size()));
+}
+
+AssetsLedger::AssetsLedger(const QString &objectsDir) : m_objectsDir(objectsDir) {}
+
+QString AssetsLedger::ledgerPath(const QString &objectsDir)
+{
+    return QDir::cleanPath(objectsDir) + ".ledger";
+}
+
+void AssetsLedger::load()
+{
+    QFile file(ledgerPath(m_objectsDir));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_ledger_magic || version != s_ledger_version)
+    {
+        qWarning() << "Ignoring assets ledger with an unknown format:" << file.fileName();
+        return;
+    }
+
+    for (auto &bucket : m_buckets)
+    {
+        quint32 count;
+        in >> bucket.recordedTimestamp >> count;
+        if (in.status() != QDataStream::Ok)
+            break;
+
+        bucket.objects.reserve(int(count));
+        for (quint32 i = 0; i < count; i++)
+        {
+            QByteArray hash(20, Qt::Uninitialized);
+            qint64 size;
+            if (in.readRawData(hash.data(), hash.size()) != hash.size())
+                break;
+            in >> size;
+            bucket.objects.insert(hash, size);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Assets ledger" << file.fileName() << "is damaged, all objects will be checked again";
+        m_buckets = {};
+        m_dirty = true;
+    }
+}
+
+void AssetsLedger::save()
+{
+    if (!m_dirty)
+        return;
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    out << s_ledger_magic << s_ledger_version;
+    for (auto &bucket : m_buckets)
+    {
+        out << bucket.recordedTimestamp << quint32(bucket.objects.size());
+        for (auto iter = bucket.objects.constBegin(); iter != bucket.objects.constEnd(); ++iter)
+        {
+            out.writeRawData(iter.key().constData(), iter.key().size());
+            out << iter.value();
+        }
+    }
+
+    try
+    {
+        FS::write(ledgerPath(m_objectsDir), data);
+        m_dirty = false;
+    }
+    catch (const Exception &e)
+    {
+        qWarning() << "Failed to save the assets ledger:" << e.cause();
+    }
+}
+
+void AssetsLedger::invalidate(const QString &objectsDir)
+{
+    QFile::remove(ledgerPath(objectsDir));
+}
+
+void AssetsLedger::refreshBucket(quint8 index)
+{
+    auto &bucket = m_buckets[index];
+    if (bucket.checked)
+        return;
+    bucket.checked = true;
+
+    auto folder = FS::PathCombine(m_objectsDir, QByteArray(1, char(index)).toHex());
+    QFileInfo info(folder);
+    bucket.currentTimestamp = info.isDir() ? info.lastModified().toUTC().toMSecsSinceEpoch() : 0;
+
+    if (bucket.currentTimestamp == bucket.recordedTimestamp)
+        return;
+
+    // something changed in there, we can't trust anything we knew about it
+    if (!bucket.objects.isEmpty())
+        m_dirty = true;
+    bucket.objects.clear();
+    bucket.recordedTimestamp = bucket.currentTimestamp;
+}
+
+bool AssetsLedger::isVerified(const AssetObject &object)
+{
+    auto index = object.hash[0];
+    refreshBucket(index);
+
+    auto &objects = m_buckets[index].objects;
+    auto iter = objects.constFind(hashKey(object));
+    return iter != objects.constEnd() && iter.value() == object.size;
+}
+
+void AssetsLedger::markVerified(const AssetObject &object)
+{
+    auto index = object.hash[0];
+    refreshBucket(index);
+
+    m_buckets[index].objects.insert(hashKey(object), object.size);
+    m_dirty = true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include <array>
+
+struct AssetObject;
+
+/**
+ * Remembers which objects of the assets object store are known to be there, with the right size,
+ * so updates don't have to look at every single file on disk.
+ *
+ * The store is split in 256 folders, by the first byte of the object hash. For each folder, the ledger
+ * keeps the modification time the folder had when its objects were checked. Adding, removing or renaming
+ * anything in a folder changes that time, and all objects recorded for the folder get checked again.
+ */
+class AssetsLedger
+{
+public:
+    explicit AssetsLedger(const QString &objectsDir);
+
+    void load();
+    void save();
+
+    /// Is the object known to be in the store?
+    bool isVerified(const AssetObject &object);
+    /// Record that the object was found in the store
+    void markVerified(const AssetObject &object);
+
+    /// Forget everything, so the next update checks every object on disk again
+    static void invalidate(const QString &objectsDir);
+
+private:
+    static QString ledgerPath(const QString &objectsDir);
+    /// Drop what we know about a folder if it changed since it was recorded
+    void refreshBucket(quint8 bucket);
+
+private:
+    struct Bucket
+    {
+        /// modification time of the folder when its objects were recorded, -1 if never
+        qint64 recordedTimestamp = -1;
+        /// same, but now. -1 until looked up, 0 if the folder doesn't exist
+        qint64 currentTimestamp = -1;
+        bool checked = false;
+        /// raw hash -> size
+        QHash<QByteArray, qint64> objects;
+    };
+
+    QString m_objectsDir;
+    std::array<Bucket, 256> m_buckets;
+    bool m_dirty = false;
+};
@@ -0,0 +1,145 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "minecraft/AssetsLedger.h"
+#include "minecraft/AssetsUtils.h"
+
+#ifdef Q_OS_UNIX
+#include <utime.h>
+#endif
+
+class AssetsLedgerTest : public QObject {
+    Q_OBJECT
+
+    static AssetObject makeObject(quint8 bucket, quint8 id, qint64 size)
+    {
+        AssetObject object;
+        object.hash[0] = bucket;
+        object.hash[19] = id;
+        object.size = size;
+        return object;
+    }
+
+    static QString bucketFolder(const QString& objectsDir, quint8 bucket)
+    {
+        return FS::PathCombine(objectsDir, QByteArray(1, char(bucket)).toHex());
+    }
+
+   private slots:
+    void test_populatedBucket()
+    {
+        QTemporaryDir dir;
+        auto objectsDir = FS::PathCombine(dir.path(), "objects");
+        QVERIFY(QDir().mkpath(bucketFolder(objectsDir, 0xab)));
+        auto object = makeObject(0xab, 1, 100);
+
+        {
+            AssetsLedger ledger(objectsDir);
+            ledger.load();
+            QVERIFY(!ledger.isVerified(object));
+            ledger.markVerified(object);
+            QVERIFY(ledger.isVerified(object));
+            ledger.save();
+        }
+
+        // the folder didn't change, so what was recorded is trusted without looking at the objects
+        AssetsLedger ledger(objectsDir);
+        ledger.load();
+        QVERIFY(ledger.isVerified(object));
+        // but only with the size it had
+        QVERIFY(!ledger.isVerified(makeObject(0xab, 1, 101)));
+        QVERIFY(!ledger.isVerified(makeObject(0xab, 2, 100)));
+    }
+
+    void test_changedBucket()
+    {
+#ifndef Q_OS_UNIX
+        QSKIP("Needs to set the modification time of a folder");
+#else
+        QTemporaryDir dir;
+        auto objectsDir = FS::PathCombine(dir.path(), "objects");
+        auto folder = bucketFolder(objectsDir, 0xab);
+        QVERIFY(QDir().mkpath(folder));
+        // far enough in the past that adding a file clearly changes it
+        auto past = QDateTime::currentDateTime().addSecs(-3600).toSecsSinceEpoch();
+        struct utimbuf times { time_t(past), time_t(past) };
+        QCOMPARE(utime(QFile::encodeName(folder).constData(), &times), 0);
+
+        auto changed = makeObject(0xab, 1, 100);
+        auto untouched = makeObject(0xcd, 1, 100);
+        QVERIFY(QDir().mkpath(bucketFolder(objectsDir, 0xcd)));
+        {
+            AssetsLedger ledger(objectsDir);
+            ledger.load();
+            ledger.markVerified(changed);
+            ledger.markVerified(untouched);
+            ledger.save();
+        }
+
+        FS::write(FS::PathCombine(folder, "something"), "new");
+
+        AssetsLedger ledger(objectsDir);
+        ledger.load();
+        QVERIFY(!ledger.isVerified(changed));
+        QVERIFY(ledger.isVerified(untouched));
+#endif
+    }
+
+    void test_invalidate()
+    {
+        QTemporaryDir dir;
+        auto objectsDir = FS::PathCombine(dir.path(), "objects");
+        QVERIFY(QDir().mkpath(bucketFolder(objectsDir, 0xab)));
+        auto object = makeObject(0xab, 1, 100);
+        {
+            AssetsLedger ledger(objectsDir);
+            ledger.markVerified(object);
+            ledger.save();
+        }
+
+        AssetsLedger::invalidate(objectsDir);
+
+        AssetsLedger ledger(objectsDir);
+        ledger.load();
+        QVERIFY(!ledger.isVerified(object));
+    }
+
+    void test_damaged()
+    {
+        QTemporaryDir dir;
+        auto objectsDir = FS::PathCombine(dir.path(), "objects");
+        QVERIFY(QDir().mkpath(bucketFolder(objectsDir, 0x00)));
+        auto object = makeObject(0x00, 1, 100);
+        {
+            AssetsLedger ledger(objectsDir);
+            ledger.markVerified(object);
+            ledger.save();
+        }
+
+        // cut off in the middle of the first bucket
+        auto ledgerPath = QDir::cleanPath(objectsDir) + ".ledger";
+        QFile file(ledgerPath);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(30));
+        file.close();
+        {
+            AssetsLedger ledger(objectsDir);
+            ledger.load();
+            QVERIFY(!ledger.isVerified(object));
+        }
+
+        // not a ledger at all
+        FS::write(ledgerPath, "garbage that happens to be long enough to read a header from");
+        AssetsLedger ledger(objectsDir);
+        ledger.load();
+        QVERIFY(!ledger.isVerified(object));
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsLedgerTest)
+
+#include "AssetsLedger_test.moc"
@@ -37,13 +37,14 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QCryptographicHash>
-#include <QJsonParseError>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QVariant>
 #include <QDebug>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <cstring>
 
 #include "AssetsUtils.h"
+#include "AssetsLedger.h"
 #include "FileSystem.h"
 #include "net/Download.h"
 #include "net/ChecksumValidator.h"
@@ -71,24 +72,14 @@ QSet<QString> collectPathsFromDir(QString dirPath)
         if(info.isFile())
         {
             out.insert(value);
-            qDebug() << value;
         }
     }
     return out;
 }
-}
-
-
-namespace AssetsUtils
-{
 
 /*
- * Returns true on success, with index populated
- * index is undefined otherwise
- */
-bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsIndex& index)
-{
-    /*
+ * Reads an assets index straight into an AssetsIndex, without building a DOM first.
+ *
     {
       "objects": {
         "icons/icon_16x16.png": {
@@ -96,93 +87,487 @@ bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsInd
           "size": 3665
         },
         ...
-        }
-      }
+      },
+      "virtual": false,
+      "map_to_resources": false
+    }
+ *
+ * Anything else in the document is validated and skipped.
+ */
+class AssetsIndexReader
+{
+public:
+    explicit AssetsIndexReader(const QByteArray &data)
+        : m_begin(data.constData()), m_cur(data.constData()), m_end(data.constData() + data.size())
+    {
     }
-    */
 
-    QFile file(path);
+    bool read(AssetsIndex &index)
+    {
+        skipWhitespace();
+        if (!consume('{'))
+            return fail("the root should be an object");
+
+        // guess how many objects there are, so we only allocate once
+        index.objects.clear();
+        index.objects.reserve(countOccurrences("\"hash\""));
+
+        return readMembers([this, &index](const Key &key) {
+            if (key == "objects")
+                return readObjects(index.objects);
+            if (key == "virtual")
+                return readFlag(index.isVirtual);
+            if (key == "map_to_resources")
+                return readFlag(index.mapToResources);
+            return skipValue(0);
+        }) && atEnd();
+    }
 
-    // Try to open the file and fail if we can't.
-    // TODO: We should probably report this error to the user.
-    if (!file.open(QIODevice::ReadOnly))
+    QString error() const
     {
-        qCritical() << "Failed to read assets index file" << path;
-        return false;
+        return m_error;
     }
-    index.id = assetsId;
 
-    // Read the file and close it.
-    QByteArray jsonData = file.readAll();
-    file.close();
+private:
+    /// A string that is either a view into the document or, if it had escapes, into a scratch buffer
+    struct Key
+    {
+        const char *data = nullptr;
+        int size = 0;
 
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+        bool operator==(const char *other) const
+        {
+            return qstrlen(other) == uint(size) && memcmp(data, other, size) == 0;
+        }
+    };
 
-    // Fail if the JSON is invalid.
-    if (parseError.error != QJsonParseError::NoError)
+    bool fail(const QString &what)
     {
-        qCritical() << "Failed to parse assets index file:" << parseError.errorString()
-                     << "at offset " << QString::number(parseError.offset);
+        if (m_error.isEmpty())
+            m_error = QString("%1 (at offset %2)").arg(what).arg(m_cur - m_begin);
         return false;
     }
 
-    // Make sure the root is an object.
-    if (!jsonDoc.isObject())
+    int countOccurrences(const char *needle) const
     {
-        qCritical() << "Invalid assets index JSON: Root should be an array.";
+        return QByteArray::fromRawData(m_cur, int(m_end - m_cur)).count(needle);
+    }
+
+    void skipWhitespace()
+    {
+        while (m_cur < m_end && (*m_cur == ' ' || *m_cur == '\n' || *m_cur == '\r' || *m_cur == '\t'))
+            m_cur++;
+    }
+
+    bool consume(char c)
+    {
+        if (m_cur < m_end && *m_cur == c)
+        {
+            m_cur++;
+            return true;
+        }
         return false;
     }
 
-    QJsonObject root = jsonDoc.object();
+    bool atEnd()
+    {
+        skipWhitespace();
+        if (m_cur != m_end)
+            return fail("unexpected data after the root object");
+        return true;
+    }
+
+    /// Reads `"key": value` pairs until the end of the current object. `readValue` is called for each key.
+    template <typename F>
+    bool readMembers(F readValue)
+    {
+        skipWhitespace();
+        if (consume('}'))
+            return true;
 
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined())
+        while (true)
+        {
+            Key key;
+            skipWhitespace();
+            if (!readString(key, m_keyScratch))
+                return false;
+            skipWhitespace();
+            if (!consume(':'))
+                return fail("expected ':'");
+            skipWhitespace();
+            if (!readValue(key))
+                return false;
+            skipWhitespace();
+            if (consume(','))
+                continue;
+            if (consume('}'))
+                return true;
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool readObjects(QVector<AssetObject> &objects)
     {
-        index.isVirtual = isVirtual.toBool(false);
+        if (!consume('{'))
+            return fail("'objects' should be an object");
+
+        return readMembers([this, &objects](const Key &key) {
+            AssetObject object;
+            object.path = QString::fromUtf8(key.data, key.size);
+            if (!consume('{'))
+                return fail("asset objects should be objects");
+
+            bool hasHash = false;
+            bool ok = readMembers([this, &object, &hasHash](const Key &field) {
+                if (field == "hash")
+                {
+                    hasHash = true;
+                    return readHash(object.hash);
+                }
+                if (field == "size")
+                    return readSize(object.size);
+                return skipValue(0);
+            });
+            if (!ok)
+                return false;
+            if (!hasHash)
+                return fail("asset object without a hash");
+
+            objects.append(std::move(object));
+            return true;
+        });
+    }
+
+    bool readFlag(bool &out)
+    {
+        // anything that isn't a boolean counts as false, like QJsonValue::toBool(false)
+        if (m_end - m_cur >= 4 && memcmp(m_cur, "true", 4) == 0)
+        {
+            m_cur += 4;
+            out = true;
+            return true;
+        }
+        if (m_end - m_cur >= 5 && memcmp(m_cur, "false", 5) == 0)
+        {
+            m_cur += 5;
+            out = false;
+            return true;
+        }
+        out = false;
+        return skipValue(0);
     }
 
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined())
+    bool readHash(std::array<quint8, 20> &out)
     {
-        index.mapToResources = mapToResources.toBool(false);
+        Key value;
+        if (!readString(value, m_valueScratch))
+            return false;
+        if (value.size != 40)
+            return fail("asset hashes should be 40 hex digits");
+
+        auto nibble = [](char c) -> int {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        };
+        for (int i = 0; i < 20; i++)
+        {
+            int hi = nibble(value.data[2 * i]);
+            int lo = nibble(value.data[2 * i + 1]);
+            if (hi < 0 || lo < 0)
+                return fail("asset hashes should be 40 hex digits");
+            out[i] = quint8((hi << 4) | lo);
+        }
+        return true;
     }
 
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
+    bool readSize(qint64 &out)
+    {
+        const char *start = m_cur;
+        bool simple = true;
+        qint64 value = 0;
+        while (m_cur < m_end && *m_cur >= '0' && *m_cur <= '9')
+        {
+            value = value * 10 + (*m_cur - '0');
+            m_cur++;
+        }
+        // sizes are plain integers, but stay correct for anything else JSON allows
+        if (m_cur == start || (m_cur < m_end && (*m_cur == '.' || *m_cur == 'e' || *m_cur == 'E')))
+        {
+            m_cur = start;
+            simple = false;
+        }
+        if (simple)
+        {
+            out = value;
+            return true;
+        }
+
+        if (!skipNumber())
+            return fail("asset sizes should be numbers");
+        out = qint64(QByteArray::fromRawData(start, int(m_cur - start)).toDouble());
+        return true;
+    }
+
+    bool skipNumber()
+    {
+        const char *start = m_cur;
+        consume('-');
+        while (m_cur < m_end && ((*m_cur >= '0' && *m_cur <= '9') || *m_cur == '.' || *m_cur == 'e' || *m_cur == 'E' ||
+                                 *m_cur == '+' || *m_cur == '-'))
+            m_cur++;
+        return m_cur != start;
+    }
+
+    static void appendUtf8(QByteArray &out, uint codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out.append(char(codepoint));
+        }
+        else if (codepoint < 0x800)
+        {
+            out.append(char(0xC0 | (codepoint >> 6)));
+            out.append(char(0x80 | (codepoint & 0x3F)));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out.append(char(0xE0 | (codepoint >> 12)));
+            out.append(char(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.append(char(0x80 | (codepoint & 0x3F)));
+        }
+        else
+        {
+            out.append(char(0xF0 | (codepoint >> 18)));
+            out.append(char(0x80 | ((codepoint >> 12) & 0x3F)));
+            out.append(char(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.append(char(0x80 | (codepoint & 0x3F)));
+        }
+    }
+
+    bool readHex4(uint &out)
+    {
+        if (m_end - m_cur < 4)
+            return fail("truncated \\u escape");
+        out = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            char c = *m_cur++;
+            out <<= 4;
+            if (c >= '0' && c <= '9')
+                out |= uint(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                out |= uint(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                out |= uint(c - 'A' + 10);
+            else
+                return fail("invalid \\u escape");
+        }
+        return true;
+    }
 
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+    /// Reads a string. Without escapes, `out` points into the document and nothing is allocated.
+    bool readString(Key &out, QByteArray &scratch)
     {
-        // qDebug() << iter.key();
+        if (!consume('"'))
+            return fail("expected a string");
 
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
+        const char *start = m_cur;
+        while (m_cur < m_end && *m_cur != '"' && *m_cur != '\\')
+        {
+            if (uchar(*m_cur) < 0x20)
+                return fail("control character in string");
+            m_cur++;
+        }
+        if (m_cur >= m_end)
+            return fail("unterminated string");
 
-        AssetObject object;
+        if (*m_cur == '"')
+        {
+            out.data = start;
+            out.size = int(m_cur - start);
+            m_cur++;
+            return true;
+        }
 
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin();
-             nested_iter != nested_objects.end(); ++nested_iter)
+        // slow path, the string has escapes
+        scratch.clear();
+        scratch.append(start, int(m_cur - start));
+        while (m_cur < m_end && *m_cur != '"')
         {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
+            char c = *m_cur++;
+            if (uchar(c) < 0x20)
+                return fail("control character in string");
+            if (c != '\\')
+            {
+                scratch.append(c);
+                continue;
+            }
+            if (m_cur >= m_end)
+                break;
+            switch (*m_cur++)
+            {
+                case '"': scratch.append('"'); break;
+                case '\\': scratch.append('\\'); break;
+                case '/': scratch.append('/'); break;
+                case 'b': scratch.append('\b'); break;
+                case 'f': scratch.append('\f'); break;
+                case 'n': scratch.append('\n'); break;
+                case 'r': scratch.append('\r'); break;
+                case 't': scratch.append('\t'); break;
+                case 'u':
+                {
+                    uint codepoint;
+                    if (!readHex4(codepoint))
+                        return false;
+                    // surrogate pair
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && m_end - m_cur >= 6 && m_cur[0] == '\\' && m_cur[1] == 'u')
+                    {
+                        m_cur += 2;
+                        uint low;
+                        if (!readHex4(low))
+                            return false;
+                        if (low >= 0xDC00 && low < 0xE000)
+                            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                        else
+                            codepoint = 0xFFFD;
+                    }
+                    else if (codepoint >= 0xD800 && codepoint < 0xE000)
+                    {
+                        codepoint = 0xFFFD;
+                    }
+                    appendUtf8(scratch, codepoint);
+                    break;
+                }
+                default:
+                    return fail("invalid escape sequence");
+            }
+        }
+        if (!consume('"'))
+            return fail("unterminated string");
 
-            if (key == "hash")
+        out.data = scratch.constData();
+        out.size = scratch.size();
+        return true;
+    }
+
+    bool skipValue(int depth)
+    {
+        if (depth > 256)
+            return fail("too deeply nested");
+        if (m_cur >= m_end)
+            return fail("unexpected end of document");
+
+        switch (*m_cur)
+        {
+            case '"':
             {
-                object.hash = value.toString();
+                Key ignored;
+                return readString(ignored, m_valueScratch);
             }
-            else if (key == "size")
+            case '{':
+                m_cur++;
+                return readMembers([this, depth](const Key &) { return skipValue(depth + 1); });
+            case '[':
             {
-                object.size = value.toDouble();
+                m_cur++;
+                skipWhitespace();
+                if (consume(']'))
+                    return true;
+                while (true)
+                {
+                    skipWhitespace();
+                    if (!skipValue(depth + 1))
+                        return false;
+                    skipWhitespace();
+                    if (consume(','))
+                        continue;
+                    if (consume(']'))
+                        return true;
+                    return fail("expected ',' or ']'");
+                }
             }
+            case 't':
+            case 'f':
+            case 'n':
+                for (const char *literal : { "true", "false", "null" })
+                {
+                    auto length = qstrlen(literal);
+                    if (uint(m_end - m_cur) >= length && memcmp(m_cur, literal, length) == 0)
+                    {
+                        m_cur += length;
+                        return true;
+                    }
+                }
+                return fail("invalid literal");
+            default:
+                if (*m_cur == '-' || (*m_cur >= '0' && *m_cur <= '9'))
+                    return skipNumber();
+                return fail("unexpected character");
         }
+    }
+
+private:
+    const char *m_begin;
+    const char *m_cur;
+    const char *m_end;
+    QByteArray m_keyScratch;
+    QByteArray m_valueScratch;
+    QString m_error;
+};
+}
+
+
+namespace AssetsUtils
+{
+
+/*
+ * Returns true on success, with index populated
+ * index is undefined otherwise
+ */
+bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsIndex& index)
+{
+    QFile file(path);
+
+    // Try to open the file and fail if we can't.
+    // TODO: We should probably report this error to the user.
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Failed to read assets index file" << path;
+        return false;
+    }
+    index.id = assetsId;
+
+    // Read the file and close it.
+    QByteArray jsonData = file.readAll();
+    file.close();
 
-        index.objects.insert(iter.key(), object);
+    QString error;
+    if (!parseAssetsIndexJson(jsonData, index, &error))
+    {
+        qCritical() << "Failed to parse assets index file" << path << ":" << error;
+        return false;
     }
 
     return true;
 }
 
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex& index, QString *error)
+{
+    AssetsIndexReader reader(data);
+    if (!reader.read(index))
+    {
+        if (error)
+            *error = reader.error();
+        return false;
+    }
+    return true;
+}
+
 // FIXME: ugly code duplication
 QDir getAssetsDir(const QString &assetsId, const QString &resourcesFolder)
 {
@@ -249,6 +634,7 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
 
     QString targetPath;
     bool removeLeftovers = false;
+    auto links = FS::CloneLinks::Any;
     if(index.isVirtual)
     {
         targetPath = virtualRoot.path();
@@ -258,97 +644,154 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
     else if(index.mapToResources)
     {
         targetPath = resourcesFolder;
+        // the instance's own folder, where the user and mods change things, those must not reach the shared objects
+        links = FS::CloneLinks::None;
         qDebug() << "Reconstructing resources folder at" << targetPath;
     }
 
-    if (!targetPath.isNull())
-    {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys())
-        {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
-
-            QString tlk = asset_object.hash.left(2);
-
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
-                continue;
-
-            presentFiles.remove(target_path);
+    if (targetPath.isNull())
+        return true;
 
-            if (!target.exists())
-            {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
+    struct CloneJob
+    {
+        QString source;
+        QString target;
+    };
+    QVector<CloneJob> toClone;
+    QSet<QString> targetDirs;
+
+    auto presentFiles = collectPathsFromDir(targetPath);
+    for (auto& asset_object : index.objects)
+    {
+        QString target_path = FS::PathCombine(targetPath, asset_object.path);
+        QString original_path = FS::PathCombine(objectDir.path(), asset_object.getRelPath());
+        // it's still in the index, so it's no leftover even if its object is missing
+        presentFiles.remove(target_path);
+        if (!QFile::exists(original_path))
+            continue;
+
+        QFileInfo target_info(target_path);
+        // a symlink to an object that isn't there anymore, or one to an object where there must be none, replace it
+        if (target_info.isSymLink() && (!target_info.exists() || links == FS::CloneLinks::None))
+            QFile::remove(target_path);
+        else if (target_info.exists())
+            continue;
+
+        targetDirs.insert(target_info.absolutePath());
+        toClone.append({ original_path, target_path });
+    }
 
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+    // create all the folders up front, so the workers don't have to fight over them
+    for (auto& dir : targetDirs)
+    {
+        FS::ensureFolderPathExists(dir);
+    }
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
-            }
+    std::atomic<int> reflinked{ 0 }, hardlinked{ 0 }, symlinked{ 0 }, copied{ 0 }, failed{ 0 };
+    QtConcurrent::blockingMap(toClone, [&](const CloneJob& job) {
+        switch (FS::cloneFile(job.source, job.target, links))
+        {
+            case FS::CloneResult::Reflinked:
+                reflinked++;
+                break;
+            case FS::CloneResult::Hardlinked:
+                hardlinked++;
+                break;
+            case FS::CloneResult::Symlinked:
+                symlinked++;
+                break;
+            case FS::CloneResult::Copied:
+                copied++;
+                break;
+            case FS::CloneResult::Failed:
+                qWarning() << "Failed to put" << job.source << "at" << job.target;
+                failed++;
+                break;
         }
+    });
+
+    if (!toClone.isEmpty())
+    {
+        qDebug() << "Reconstructed" << toClone.size() << "assets in" << targetPath << ":" << reflinked.load() << "reflinked,"
+                 << hardlinked.load() << "hard linked," << symlinked.load() << "symlinked," << copied.load() << "copied,"
+                 << failed.load() << "failed";
+    }
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if(removeLeftovers)
+    // TODO: Write last used time to virtualRoot/.lastused
+    if (removeLeftovers)
+    {
+        for (auto& file : presentFiles)
         {
-            for(auto & file: presentFiles)
-            {
-                qDebug() << "Would remove" << file;
-            }
+            qDebug() << "Removing leftover asset" << file;
+            QFile::remove(file);
         }
     }
-    return true;
+
+    return failed == 0;
 }
 
 }
 
-NetAction::Ptr AssetObject::getDownloadAction()
+NetAction::Ptr AssetObject::getDownloadAction() const
 {
     QFileInfo objectFile(getLocalPath());
     if ((!objectFile.isFile()) || (objectFile.size() != size))
     {
         auto objectDL = Net::Download::makeFile(getUrl(), objectFile.filePath());
-        if(hash.size())
-        {
-            auto rawHash = QByteArray::fromHex(hash.toLatin1());
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
-        }
+        auto rawHash = QByteArray(reinterpret_cast<const char*>(hash.data()), int(hash.size()));
+        objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
         objectDL->setProgress(objectDL->getProgress(), size);
         return objectDL;
     }
     return nullptr;
 }
 
-QString AssetObject::getLocalPath()
+QString AssetObject::getHexHash() const
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(hash.data()), int(hash.size())).toHex();
+}
+
+QString AssetObject::getLocalPath() const
 {
     return "assets/objects/" + getRelPath();
 }
 
-QUrl AssetObject::getUrl()
+QUrl AssetObject::getUrl() const
 {
     return BuildConfig.RESOURCE_BASE + getRelPath();
 }
 
-QString AssetObject::getRelPath()
+QString AssetObject::getRelPath() const
 {
-    return hash.left(2) + "/" + hash;
+    auto hexHash = getHexHash();
+    return hexHash.left(2) + "/" + hexHash;
 }
 
 NetJob::Ptr AssetsIndex::getDownloadJob()
 {
     auto job = new NetJob(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto &object : objects.values())
+
+    // only look at the files we don't already know about
+    AssetsLedger ledger("assets/objects");
+    ledger.load();
+    for (auto &object : objects)
     {
+        if (ledger.isVerified(object))
+        {
+            continue;
+        }
         auto dl = object.getDownloadAction();
         if(dl)
         {
             job->addNetAction(dl);
         }
+        else
+        {
+            ledger.markVerified(object);
+        }
     }
+    ledger.save();
+
     if(job->size())
         return job;
     return nullptr;
@@ -16,19 +16,24 @@
 #pragma once
 
 #include <QString>
-#include <QMap>
+#include <QVector>
+#include <array>
 #include "net/NetAction.h"
 #include "net/NetJob.h"
 
 struct AssetObject
 {
-    QString getRelPath();
-    QUrl getUrl();
-    QString getLocalPath();
-    NetAction::Ptr getDownloadAction();
-
-    QString hash;
-    qint64 size;
+    QString getHexHash() const;
+    QString getRelPath() const;
+    QUrl getUrl() const;
+    QString getLocalPath() const;
+    NetAction::Ptr getDownloadAction() const;
+
+    /// Path of the object inside a virtual assets / resources folder
+    QString path;
+    /// Raw SHA-1 of the object
+    std::array<quint8, 20> hash {};
+    qint64 size = 0;
 };
 
 struct AssetsIndex
@@ -36,7 +41,7 @@ struct AssetsIndex
     NetJob::Ptr getDownloadJob();
 
     QString id;
-    QMap<QString, AssetObject> objects;
+    QVector<AssetObject> objects;
     bool isVirtual = false;
     bool mapToResources = false;
 };
@@ -46,6 +51,9 @@ namespace AssetsUtils
 {
 bool loadAssetsIndexJson(const QString &id, const QString &file, AssetsIndex& index);
 
+/// Parse the contents of an assets index. Returns false (and fills in `error`) if the data is not a valid index.
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex& index, QString *error = nullptr);
+
 QDir getAssetsDir(const QString &assetsId, const QString &resourcesFolder);
 
 /// Reconstruct a virtual assets folder for the given assets ID and return the folder
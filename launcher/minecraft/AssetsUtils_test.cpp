@@ -0,0 +1,124 @@
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include "minecraft/AssetsUtils.h"
+
+class AssetsUtilsTest : public QObject {
+    Q_OBJECT
+
+#ifdef LAUNCHER_BENCHMARKS
+    static QByteArray makeIndex(int count)
+    {
+        QByteArray data = "{\n  \"objects\": {\n";
+        for (int i = 0; i < count; i++) {
+            auto hash = QByteArray::number(i * 7919, 16).rightJustified(40, 'a');
+            data += QString("    \"minecraft/sounds/random/sound_%1.ogg\": {\n      \"hash\": \"%2\",\n      \"size\": %3\n    }%4\n")
+                        .arg(i)
+                        .arg(QString(hash))
+                        .arg(i * 13)
+                        .arg(i + 1 < count ? "," : "")
+                        .toUtf8();
+        }
+        data += "  }\n}\n";
+        return data;
+    }
+
+    // What loadAssetsIndexJson() used to do, kept around to compare against.
+    static int parseThroughVariants(const QByteArray& data)
+    {
+        auto root = QJsonDocument::fromJson(data).object();
+        QVariantMap map = root.value("objects").toVariant().toMap();
+        int count = 0;
+        for (auto iter = map.begin(); iter != map.end(); ++iter) {
+            QVariantMap nested = iter.value().toMap();
+            QString hash = nested.value("hash").toString();
+            qint64 size = nested.value("size").toDouble();
+            count += hash.size() > 0 && size >= 0;
+        }
+        return count;
+    }
+#endif
+
+   private slots:
+    void test_parse()
+    {
+        QByteArray data = R"({
+            "map_to_resources": true,
+            "unknown": [1, 2.5e3, {"nested": [true, false, null]}, "\"quoted\""],
+            "objects": {
+                "icons/icon_16x16.png": { "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 3665 },
+                "sounds/café 😀.ogg": { "size": 12.0, "hash": "BDF48EF6B5D0D23BBB02E17D04865216179F510A", "extra": {} }
+            }
+        })";
+
+        AssetsIndex index;
+        QString error;
+        QVERIFY2(AssetsUtils::parseAssetsIndexJson(data, index, &error), qPrintable(error));
+
+        QVERIFY(index.mapToResources);
+        QVERIFY(!index.isVirtual);
+        QCOMPARE(index.objects.size(), 2);
+
+        QCOMPARE(index.objects[0].path, QString("icons/icon_16x16.png"));
+        QCOMPARE(index.objects[0].getHexHash(), QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(index.objects[0].getRelPath(), QString("bd/bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(index.objects[0].size, qint64(3665));
+
+        QCOMPARE(index.objects[1].path, QString::fromUtf8("sounds/caf\xc3\xa9 \xf0\x9f\x98\x80.ogg"));
+        QCOMPARE(index.objects[1].getHexHash(), QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(index.objects[1].size, qint64(12));
+    }
+
+    void test_reject_data()
+    {
+        QTest::addColumn<QByteArray>("data");
+
+        QTest::newRow("not an object") << QByteArray("[]");
+        QTest::newRow("truncated") << QByteArray(R"({"objects": {"a": {"hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a")");
+        QTest::newRow("short hash") << QByteArray(R"({"objects": {"a": {"hash": "bdf48ef6", "size": 1}}})");
+        QTest::newRow("bad hash") << QByteArray(R"({"objects": {"a": {"hash": "zdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 1}}})");
+        QTest::newRow("no hash") << QByteArray(R"({"objects": {"a": {"size": 1}}})");
+        QTest::newRow("trailing data") << QByteArray(R"({"objects": {}} {})");
+    }
+    void test_reject()
+    {
+        QFETCH(QByteArray, data);
+
+        AssetsIndex index;
+        QVERIFY(!AssetsUtils::parseAssetsIndexJson(data, index));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_parse_data()
+    {
+        QTest::addColumn<bool>("typed");
+
+        QTest::newRow("variant maps") << false;
+        QTest::newRow("typed reader") << true;
+    }
+    void benchmark_parse()
+    {
+        QFETCH(bool, typed);
+        auto data = makeIndex(5000);
+
+        if (typed) {
+            QBENCHMARK
+            {
+                AssetsIndex index;
+                AssetsUtils::parseAssetsIndexJson(data, index);
+                QCOMPARE(index.objects.size(), 5000);
+            }
+        } else {
+            QBENCHMARK
+            {
+                QCOMPARE(parseThroughVariants(data), 5000);
+            }
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(AssetsUtilsTest)
+
+#include "AssetsUtils_test.moc"
@@ -47,10 +47,15 @@ void LaunchProfile::clear()
     m_mainClass.clear();
     m_appletClass.clear();
     m_libraries.clear();
+    m_libraryIndex.clear();
+    m_nativeLibraries.clear();
+    m_nativeLibraryIndex.clear();
     m_mavenFiles.clear();
     m_agents.clear();
     m_traits.clear();
     m_jarMods.clear();
+    m_mods.clear();
+    m_modIndex.clear();
     m_mainJar.reset();
     m_problemSeverity = ProblemSeverity::None;
 }
@@ -127,44 +132,41 @@ void LaunchProfile::applyJarMods(const QList<LibraryPtr>& jarMods)
     this->m_jarMods.append(jarMods);
 }
 
-static int findLibraryByName(QList<LibraryPtr> *haystack, const GradleSpecifier &needle)
+// Two libraries are the same if GradleSpecifier::matchName() says so, this is what it compares.
+static QString libraryKey(const GradleSpecifier &name)
 {
-    int retval = -1;
-    for (int i = 0; i < haystack->size(); ++i)
+    return name.groupId() + ':' + name.artifactId() + ':' + name.classifier();
+}
+
+/*
+ * Add the library to the list, or replace the one with the same name if the new one is a higher version.
+ * The index always has one entry for each library in the list, so lookups don't need to scan it.
+ */
+static void applyByName(QList<LibraryPtr> &list, QHash<QString, int> &index, LibraryPtr library)
+{
+    auto key = libraryKey(library->rawName());
+    auto existing = index.constFind(key);
+    // library not found? just add it.
+    if (existing == index.constEnd())
     {
-        if (haystack->at(i)->rawName().matchName(needle))
-        {
-            // only one is allowed.
-            if (retval != -1)
-                return -1;
-            retval = i;
-        }
+        index.insert(key, list.size());
+        list.append(Library::limitedCopy(library));
+        return;
+    }
+
+    auto existingLibrary = list.at(existing.value());
+    // if we are higher it means we should update
+    if (Version(library->version()) > Version(existingLibrary->version()))
+    {
+        list.replace(existing.value(), Library::limitedCopy(library));
     }
-    return retval;
 }
 
 void LaunchProfile::applyMods(const QList<LibraryPtr>& mods)
 {
-    QList<LibraryPtr> * list = &m_mods;
     for(auto & mod: mods)
     {
-        auto modCopy = Library::limitedCopy(mod);
-
-        // find the mod by name.
-        const int index = findLibraryByName(list, mod->rawName());
-        // mod not found? just add it.
-        if (index < 0)
-        {
-            list->append(modCopy);
-            return;
-        }
-
-        auto existingLibrary = list->at(index);
-        // if we are higher it means we should update
-        if (Version(mod->version()) > Version(existingLibrary->version()))
-        {
-            list->replace(index, modCopy);
-        }
+        applyByName(m_mods, m_modIndex, mod);
     }
 }
 
@@ -180,28 +182,13 @@ void LaunchProfile::applyLibrary(LibraryPtr library)
         return;
     }
 
-    QList<LibraryPtr> * list = &m_libraries;
     if(library->isNative())
     {
-        list = &m_nativeLibraries;
-    }
-
-    auto libraryCopy = Library::limitedCopy(library);
-
-    // find the library by name.
-    const int index = findLibraryByName(list, library->rawName());
-    // library not found? just add it.
-    if (index < 0)
-    {
-        list->append(libraryCopy);
-        return;
+        applyByName(m_nativeLibraries, m_nativeLibraryIndex, library);
     }
-
-    auto existingLibrary = list->at(index);
-    // if we are higher it means we should update
-    if (Version(library->version()) > Version(existingLibrary->version()))
+    else
     {
-        list->replace(index, libraryCopy);
+        applyByName(m_libraries, m_libraryIndex, library);
     }
 }
 
@@ -35,6 +35,7 @@
 
 #pragma once
 #include <QString>
+#include <QHash>
 #include "Library.h"
 #include "Agent.h"
 #include <ProblemProvider.h>
@@ -129,6 +130,9 @@ private:
     /// the list of libraries
     QList<LibraryPtr> m_libraries;
 
+    /// position of each library in m_libraries, by group:artifact:classifier
+    QHash<QString, int> m_libraryIndex;
+
     /// the list of maven files to be placed in the libraries folder, but not acted upon
     QList<LibraryPtr> m_mavenFiles;
 
@@ -141,6 +145,9 @@ private:
     /// the list of native libraries
     QList<LibraryPtr> m_nativeLibraries;
 
+    /// position of each library in m_nativeLibraries, by group:artifact:classifier
+    QHash<QString, int> m_nativeLibraryIndex;
+
     /// traits, collected from all the version files (version files can only add)
     QSet<QString> m_traits;
 
@@ -150,6 +157,9 @@ private:
     /// the list of mods
     QList<LibraryPtr> m_mods;
 
+    /// position of each mod in m_mods, by group:artifact:classifier
+    QHash<QString, int> m_modIndex;
+
     /// compatible java major versions
     QList<int> m_compatibleJavaMajors;
 
@@ -0,0 +1,90 @@
+#include <QTest>
+
+#include "minecraft/LaunchProfile.h"
+#include "minecraft/VersionFile.h"
+
+class LaunchProfileTest : public QObject {
+    Q_OBJECT
+
+    static LibraryPtr makeLibrary(const QString& name)
+    {
+        return std::make_shared<Library>(name);
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    /*
+     * A stack of components like a big modpack has: every component brings its own libraries, and bumps the
+     * versions of some libraries the ones before it already brought.
+     */
+    static QList<VersionFilePtr> makeComponents(int components, int librariesPerComponent)
+    {
+        QList<VersionFilePtr> files;
+        for (int c = 0; c < components; c++) {
+            auto file = std::make_shared<VersionFile>();
+            file->uid = QString("org.example.component%1").arg(c);
+            for (int l = 0; l < librariesPerComponent; l++) {
+                file->libraries.append(makeLibrary(QString("org.example.c%1:library%2:1.%3").arg(c).arg(l).arg(c)));
+                if (c > 0)
+                    file->libraries.append(makeLibrary(QString("org.example.c%1:library%2:2.%3").arg(c - 1).arg(l).arg(c)));
+            }
+            files.append(file);
+        }
+        return files;
+    }
+#endif
+
+   private slots:
+    void test_applyLibrary()
+    {
+        LaunchProfile profile;
+        profile.applyLibrary(makeLibrary("org.example:first:1.0"));
+        profile.applyLibrary(makeLibrary("org.example:second:1.0"));
+        profile.applyLibrary(makeLibrary("org.example:second:1.0:sources"));
+        profile.applyLibrary(makeLibrary("org.example:first:2.0"));
+        profile.applyLibrary(makeLibrary("org.example:second:0.9"));
+
+        auto libraries = profile.getLibraries();
+        QCOMPARE(libraries.size(), 3);
+        // replaced in place, with the higher version
+        QCOMPARE(libraries[0]->rawName().serialize(), QString("org.example:first:2.0"));
+        // lower versions don't replace anything
+        QCOMPARE(libraries[1]->rawName().serialize(), QString("org.example:second:1.0"));
+        // a different classifier is a different library
+        QCOMPARE(libraries[2]->rawName().serialize(), QString("org.example:second:1.0:sources"));
+
+        profile.clear();
+        profile.applyLibrary(makeLibrary("org.example:first:1.0"));
+        QCOMPARE(profile.getLibraries().size(), 1);
+        QCOMPARE(profile.getLibraries()[0]->rawName().serialize(), QString("org.example:first:1.0"));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_applyComponents_data()
+    {
+        QTest::addColumn<int>("components");
+        QTest::addColumn<int>("librariesPerComponent");
+
+        QTest::newRow("vanilla sized") << 3 << 40;
+        QTest::newRow("modded") << 10 << 100;
+        QTest::newRow("huge modpack") << 30 << 200;
+    }
+    void benchmark_applyComponents()
+    {
+        QFETCH(int, components);
+        QFETCH(int, librariesPerComponent);
+        auto files = makeComponents(components, librariesPerComponent);
+
+        QBENCHMARK
+        {
+            LaunchProfile profile;
+            for (auto& file : files)
+                file->applyTo(&profile);
+            QCOMPARE(profile.getLibraries().size(), components * librariesPerComponent);
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(LaunchProfileTest)
+
+#include "LaunchProfile_test.moc"
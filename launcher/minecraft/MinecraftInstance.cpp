@@ -811,53 +811,6 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
     return filter;
 }
 
-MessageLevel::Enum MinecraftInstance::guessLevel(const QString &line, MessageLevel::Enum level)
-{
-    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-    auto match = re.match(line);
-    if(match.hasMatch())
-    {
-        // New style logs from log4j
-        QString timestamp = match.captured("timestamp");
-        QString levelStr = match.captured("level");
-        if(levelStr == "INFO")
-            level = MessageLevel::Message;
-        if(levelStr == "WARN")
-            level = MessageLevel::Warning;
-        if(levelStr == "ERROR")
-            level = MessageLevel::Error;
-        if(levelStr == "FATAL")
-            level = MessageLevel::Fatal;
-        if(levelStr == "TRACE" || levelStr == "DEBUG")
-            level = MessageLevel::Debug;
-    }
-    else
-    {
-        // Old style forge logs
-        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
-            line.contains("[FINER]") || line.contains("[FINEST]"))
-            level = MessageLevel::Message;
-        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-            level = MessageLevel::Error;
-        if (line.contains("[WARNING]"))
-            level = MessageLevel::Warning;
-        if (line.contains("[DEBUG]"))
-            level = MessageLevel::Debug;
-    }
-    if (line.contains("overwriting existing"))
-        return MessageLevel::Fatal;
-    //NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-    if (line.contains("Exception in thread")
-        || line.contains(QRegularExpression("\\s+at " + javaSymbol))
-        || line.contains(QRegularExpression("Caused by: " + javaSymbol))
-        || line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
-        || line.contains(QRegularExpression("... \\d+ more$"))
-        )
-        return MessageLevel::Error;
-    return level;
-}
-
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
 {
     auto combined = std::make_shared<MultiMatcher>();
@@ -1080,6 +1033,7 @@ std::shared_ptr<ModFolderModel> MinecraftInstance::loaderModList() const
     {
         bool is_indexed = !APPLICATION->settings()->get("ModMetadataDisabled").toBool();
         m_loader_mod_list.reset(new ModFolderModel(modsRoot(), is_indexed));
+        m_loader_mod_list->setDetailsCache(APPLICATION->modDetailsCache());
         m_loader_mod_list->disableInteraction(isRunning());
         connect(this, &BaseInstance::runningStatusChanged, m_loader_mod_list.get(), &ModFolderModel::disableInteraction);
     }
@@ -1092,6 +1046,7 @@ std::shared_ptr<ModFolderModel> MinecraftInstance::coreModList() const
     {
         bool is_indexed = !APPLICATION->settings()->get("ModMetadataDisabled").toBool();
         m_core_mod_list.reset(new ModFolderModel(coreModsDir(), is_indexed));
+        m_core_mod_list->setDetailsCache(APPLICATION->modDetailsCache());
         m_core_mod_list->disableInteraction(isRunning());
         connect(this, &BaseInstance::runningStatusChanged, m_core_mod_list.get(), &ModFolderModel::disableInteraction);
     }
@@ -21,7 +21,14 @@
 #include <quazip/quazipdir.h>
 #include "MMCZip.h"
 #include "FileSystem.h"
+#include "Application.h"
+#include "modplatform/helpers/HashCache.h"
+#include <QCryptographicHash>
 #include <QDir>
+#include <QDirIterator>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QtConcurrent>
 
 #ifdef major
     #undef major
@@ -80,6 +87,127 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
     return true;
 }
 
+namespace {
+struct NativesOptions
+{
+    bool applyJnilibHack;
+    bool nativeOpenAL;
+    bool nativeGLFW;
+};
+
+struct CachedNatives
+{
+    QString source;
+    QString cacheDir;
+    bool extracted = true;
+};
+
+/*
+ * Natives are extracted once into a shared cache, in a folder named after everything that affects the result:
+ * the contents of the jar, the platform and the extraction options.
+ * The jar is only read again when the hash cache sees that it changed.
+ */
+QString nativesCacheKey(Hashing::HashCache &hashes, const QString &source, const NativesOptions &options)
+{
+    auto jarHashes = hashes.hash(source, Hashing::Algorithm::Sha1);
+    if (!jarHashes || jarHashes->sha1.isEmpty())
+    {
+        return {};
+    }
+
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(jarHashes->sha1);
+    key.addData(QSysInfo::kernelType().toUtf8());
+    key.addData(QSysInfo::currentCpuArchitecture().toUtf8());
+    key.addData(QByteArray(1, options.applyJnilibHack ? '1' : '0'));
+    key.addData(QByteArray(1, options.nativeOpenAL ? '1' : '0'));
+    key.addData(QByteArray(1, options.nativeGLFW ? '1' : '0'));
+    return key.result().toHex();
+}
+
+bool extractToCache(const CachedNatives &entry, const NativesOptions &options)
+{
+    // extract next to the final location, then move it in place, so nobody ever sees half of it
+    QTemporaryDir staging(entry.cacheDir + ".tmp-XXXXXX");
+    if (!staging.isValid())
+    {
+        return false;
+    }
+    if (!unzipNatives(entry.source, staging.path(), options.applyJnilibHack, options.nativeOpenAL, options.nativeGLFW))
+    {
+        return false;
+    }
+    // if this fails, somebody else may have been faster than us, which is fine too
+    return QDir().rename(staging.path(), entry.cacheDir) || QDir(entry.cacheDir).exists();
+}
+
+bool linkTree(const QString &sourceDir, const QString &targetDir)
+{
+    QDir source(sourceDir);
+    QDirIterator iter(sourceDir, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (iter.hasNext())
+    {
+        QString sourcePath = iter.next();
+        QString targetPath = FS::PathCombine(targetDir, source.relativeFilePath(sourcePath));
+        if (!FS::ensureFilePathExists(targetPath))
+        {
+            return false;
+        }
+        QFile::remove(targetPath);
+        if (FS::cloneFile(sourcePath, targetPath) == FS::CloneResult::Failed)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Returns an error message, or an empty string on success
+QString extractNatives(std::shared_ptr<Hashing::HashCache> hashes, const QStringList &sources, const QString &cacheRoot,
+                       const QString &outputPath, const NativesOptions &options)
+{
+    QVector<CachedNatives> entries;
+    QVector<CachedNatives> misses;
+    for (const auto &source : sources)
+    {
+        auto key = nativesCacheKey(*hashes, source, options);
+        if (key.isEmpty())
+        {
+            return QObject::tr("Couldn't read native jar '%1'").arg(source);
+        }
+        CachedNatives entry { source, FS::PathCombine(cacheRoot, key) };
+        if (!QDir(entry.cacheDir).exists())
+        {
+            misses.append(entry);
+        }
+        entries.append(entry);
+    }
+
+    if (!misses.isEmpty())
+    {
+        FS::ensureFolderPathExists(cacheRoot);
+        QtConcurrent::blockingMap(misses, [&options](CachedNatives &entry) { entry.extracted = extractToCache(entry, options); });
+        for (const auto &entry : misses)
+        {
+            if (!entry.extracted)
+            {
+                return QObject::tr("Couldn't extract native jar '%1' to '%2'").arg(entry.source, entry.cacheDir);
+            }
+        }
+    }
+
+    // later jars win when they contain the same files, like they did when extracted in place
+    for (const auto &entry : entries)
+    {
+        if (!linkTree(entry.cacheDir, outputPath))
+        {
+            return QObject::tr("Couldn't put the natives of '%1' into '%2'").arg(entry.source, outputPath);
+        }
+    }
+    return {};
+}
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
@@ -91,20 +219,29 @@ void ExtractNatives::executeTask()
         return;
     }
     auto settings = minecraftInstance->settings();
-    bool nativeOpenAL = settings->get("UseNativeOpenAL").toBool();
-    bool nativeGLFW = settings->get("UseNativeGLFW").toBool();
+    NativesOptions options;
+    options.nativeOpenAL = settings->get("UseNativeOpenAL").toBool();
+    options.nativeGLFW = settings->get("UseNativeGLFW").toBool();
 
     auto outputPath  = minecraftInstance->getNativePath();
     auto javaVersion = minecraftInstance->getJavaVersion();
-    bool jniHackEnabled = javaVersion.major() >= 8;
-    for(const auto &source: toExtract)
+    options.applyJnilibHack = javaVersion.major() >= 8;
+
+    auto cacheRoot = QDir("cache/natives").absolutePath();
+
+    connect(&m_extractWatcher, &QFutureWatcher<QString>::finished, this, &ExtractNatives::extractionFinished, Qt::UniqueConnection);
+    m_extractWatcher.setFuture(
+        QtConcurrent::run(QThreadPool::globalInstance(), extractNatives, APPLICATION->hashCache(), toExtract, cacheRoot, outputPath, options));
+}
+
+void ExtractNatives::extractionFinished()
+{
+    auto error = m_extractWatcher.result();
+    if (!error.isEmpty())
     {
-        if(!unzipNatives(source, outputPath, jniHackEnabled, nativeOpenAL, nativeGLFW))
-        {
-            const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
-            emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
-            emitFailed(tr(reason).arg(source, outputPath));
-        }
+        emit logLine(error, MessageLevel::Fatal);
+        emitFailed(error);
+        return;
     }
     emitSucceeded();
 }
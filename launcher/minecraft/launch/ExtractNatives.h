@@ -17,6 +17,7 @@
 
 #include <launch/LaunchStep.h>
 #include <memory>
+#include <QFutureWatcher>
 #include "minecraft/auth/AuthSession.h"
 
 // FIXME: temporary wrapper for existing task.
@@ -33,6 +34,12 @@ public:
         return false;
     }
     void finalize() override;
+
+private slots:
+    void extractionFinished();
+
+private:
+    QFutureWatcher<QString> m_extractWatcher;
 };
 
 
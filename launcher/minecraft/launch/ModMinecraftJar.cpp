@@ -20,13 +20,144 @@
 #include "FileSystem.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
+#include "Application.h"
+#include "modplatform/helpers/HashCache.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+bool addFileToHash(QCryptographicHash &key, Hashing::HashCache &hashes, const QString &path)
+{
+    auto fileHashes = hashes.hash(path, Hashing::Algorithm::Sha1);
+    if (!fileHashes || fileHashes->sha1.isEmpty())
+    {
+        return false;
+    }
+    key.addData(fileHashes->sha1);
+    return true;
+}
+
+/*
+ * The modded jar only depends on the base jar and the enabled jar mods, in order.
+ * The files are hashed through the hash cache, so unchanged ones aren't read again on every launch.
+ * Returns an empty string if any of them can't be read.
+ */
+QString moddedJarKey(Hashing::HashCache &hashes, const QString &sourceJarPath, const QList<Mod*> &mods)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    if (!addFileToHash(key, hashes, sourceJarPath))
+    {
+        return {};
+    }
+    for (const auto *mod : mods)
+    {
+        if (!mod->enabled())
+            continue;
+
+        auto fileinfo = mod->fileinfo();
+        key.addData(QByteArray::number(int(mod->type())));
+        key.addData(fileinfo.fileName().toUtf8());
+        if (mod->type() == ResourceType::FOLDER)
+        {
+            QFileInfoList files;
+            MMCZip::collectFileListRecursively(fileinfo.absoluteFilePath(), nullptr, &files, nullptr);
+            std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) { return a.filePath() < b.filePath(); });
+            for (const auto &file : files)
+            {
+                key.addData(QDir(fileinfo.absoluteFilePath()).relativeFilePath(file.absoluteFilePath()).toUtf8());
+                if (!addFileToHash(key, hashes, file.absoluteFilePath()))
+                {
+                    return {};
+                }
+            }
+        }
+        else if (!addFileToHash(key, hashes, fileinfo.absoluteFilePath()))
+        {
+            return {};
+        }
+    }
+    return key.result().toHex();
+}
+
+/// Returns an error message, or an empty string on success
+QString buildModdedJar(std::shared_ptr<Hashing::HashCache> hashes, const QString &sourceJarPath, const QString &finalJarPath,
+                       const QStringList &jarModPaths)
+{
+    std::vector<std::unique_ptr<Mod>> ownedMods;
+    QList<Mod*> mods;
+    for (const auto &path : jarModPaths)
+    {
+        ownedMods.emplace_back(new Mod(QFileInfo(path)));
+        mods.append(ownedMods.back().get());
+    }
+
+    auto keyPath = finalJarPath + ".key";
+    auto key = moddedJarKey(*hashes, sourceJarPath, mods);
+
+    if (!key.isEmpty() && QFile::exists(finalJarPath))
+    {
+        QFile keyFile(keyPath);
+        if (keyFile.open(QIODevice::ReadOnly) && keyFile.readAll() == key.toLatin1())
+        {
+            qDebug() << "Reusing the custom Minecraft jar built from the same jar mods:" << finalJarPath;
+            return {};
+        }
+    }
+
+    // something changed, or we don't know, so build it again
+    QFile::remove(keyPath);
+    QFile::remove(finalJarPath);
+
+    auto stagingJarPath = finalJarPath + ".tmp";
+    QFile::remove(stagingJarPath);
+    if (!MMCZip::createModdedJar(sourceJarPath, stagingJarPath, mods))
+    {
+        return QObject::tr("Failed to create the custom Minecraft jar file.");
+    }
+    if (!QFile::rename(stagingJarPath, finalJarPath))
+    {
+        QFile::remove(stagingJarPath);
+        return QObject::tr("Couldn't move the custom Minecraft jar file to %1").arg(finalJarPath);
+    }
+
+    if (!key.isEmpty())
+    {
+        try
+        {
+            FS::write(keyPath, key.toLatin1());
+        }
+        catch (const Exception &e)
+        {
+            // not fatal, it only means we will build it again next time
+            qWarning() << "Couldn't remember what the custom Minecraft jar was built from:" << e.cause();
+        }
+    }
+    return {};
+}
+}
 
 void ModMinecraftJar::executeTask()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
 
-    if(!m_inst->getJarMods().size())
+    // the build only gets the paths, the mods themselves stay on this thread
+    QStringList jarModPaths;
+    for (auto *mod : m_inst->getJarMods())
+    {
+        jarModPaths.append(mod->fileinfo().absoluteFilePath());
+        delete mod;
+    }
+
+    if(jarModPaths.isEmpty())
     {
+        // don't leave an old modded jar lying around
+        removeJar();
         emitSucceeded();
         return;
     }
@@ -34,42 +165,45 @@ void ModMinecraftJar::executeTask()
     if(!FS::ensureFolderPathExists(m_inst->binRoot()))
     {
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
-    if(!removeJar())
-    {
-        emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
-    }
 
-    // create temporary modded jar, if needed
+    // create the modded jar, if it's not there already
     auto components = m_inst->getPackProfile();
     auto profile = components->getProfile();
-    auto jarMods = m_inst->getJarMods();
-    if(jarMods.size())
+    auto mainJar = profile->getMainJar();
+    QStringList jars, temp1, temp2, temp3, temp4;
+    mainJar->getApplicableFiles(currentSystem, jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
+    auto sourceJarPath = jars[0];
+
+    connect(&m_buildWatcher, &QFutureWatcher<QString>::finished, this, &ModMinecraftJar::buildFinished, Qt::UniqueConnection);
+    m_buildWatcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), buildModdedJar, APPLICATION->hashCache(), sourceJarPath,
+                                               finalJarPath, jarModPaths));
+}
+
+void ModMinecraftJar::buildFinished()
+{
+    auto error = m_buildWatcher.result();
+    if (!error.isEmpty())
     {
-        auto mainJar = profile->getMainJar();
-        QStringList jars, temp1, temp2, temp3, temp4;
-        mainJar->getApplicableFiles(currentSystem, jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
-        auto sourceJarPath = jars[0];
-        if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
-        {
-            emitFailed(tr("Failed to create the custom Minecraft jar file."));
-            return;
-        }
+        emitFailed(error);
+        return;
     }
     emitSucceeded();
 }
 
 void ModMinecraftJar::finalize()
 {
-    removeJar();
+    // the jar is kept around, and reused on the next launch if the jar mods didn't change
 }
 
 bool ModMinecraftJar::removeJar()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
+    QFile::remove(finalJarPath + ".key");
     QFile finalJar(finalJarPath);
     if(finalJar.exists())
     {
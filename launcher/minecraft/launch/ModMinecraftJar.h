@@ -17,6 +17,7 @@
 
 #include <launch/LaunchStep.h>
 #include <memory>
+#include <QFutureWatcher>
 
 class ModMinecraftJar: public LaunchStep
 {
@@ -31,6 +32,13 @@ public:
         return false;
     }
     void finalize() override;
+
+private slots:
+    void buildFinished();
+
 private:
     bool removeJar();
+
+private:
+    QFutureWatcher<QString> m_buildWatcher;
 };
@@ -0,0 +1,157 @@
+#include "ModDetailsCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/HashCache.h"
+
+static const quint32 s_cache_magic = 0x4d444443;  // "MDDC"
+// bump this when the parsers in LocalModParseTask change what they get out of a mod
+static const quint32 s_cache_version = 1;
+
+// how long an entry is kept after it was last used
+static const qint64 s_max_unused_days = 180;
+
+static qint64 today()
+{
+    return QDateTime::currentMSecsSinceEpoch() / (24 * 60 * 60 * 1000);
+}
+
+static QDataStream& operator<<(QDataStream& out, const ModDetails& details)
+{
+    out << details.mod_id << details.name << details.version << details.mcversion << details.homeurl << details.description
+        << details.authors;
+    return out;
+}
+
+static QDataStream& operator>>(QDataStream& in, ModDetails& details)
+{
+    in >> details.mod_id >> details.name >> details.version >> details.mcversion >> details.homeurl >> details.description
+        >> details.authors;
+    return in;
+}
+
+ModDetailsCache::ModDetailsCache(QString cache_path, std::shared_ptr<Hashing::HashCache> hashes)
+    : m_cache_path(std::move(cache_path)), m_hashes(std::move(hashes))
+{}
+
+ModDetailsCache::~ModDetailsCache()
+{
+    save();
+}
+
+QByteArray ModDetailsCache::fingerprint(const QString& path)
+{
+    // only what we need for the key, the other hashes are for updating mods, which might never happen
+    auto hashes = m_hashes->hash(path, Hashing::Algorithm::Sha1);
+    if (!hashes)
+        return {};
+    return hashes->sha1;
+}
+
+std::optional<ModDetails> ModDetailsCache::find(const QString& path)
+{
+    auto key = fingerprint(path);
+    if (key.isEmpty())
+        return {};
+
+    QMutexLocker locker(&m_mutex);
+    auto iter = m_entries.find(key);
+    if (iter == m_entries.end())
+        return {};
+
+    if (iter->last_used != today()) {
+        iter->last_used = today();
+        m_dirty = true;
+    }
+    return iter->details;
+}
+
+void ModDetailsCache::insert(const QString& path, const ModDetails& details)
+{
+    auto key = fingerprint(path);
+    if (key.isEmpty())
+        return;
+
+    Entry entry;
+    entry.details = details;
+    // the rest depends on where the file is, not on what's in it
+    entry.details.status = ModStatus::Unknown;
+    entry.details.metadata = nullptr;
+    entry.last_used = today();
+
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, entry);
+    m_dirty = true;
+}
+
+void ModDetailsCache::load()
+{
+    QFile file(m_cache_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version) {
+        qDebug() << "Ignoring mod details cache with an old or unknown format:" << file.fileName();
+        return;
+    }
+
+    QHash<QByteArray, Entry> entries;
+    entries.reserve(int(count));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QByteArray key;
+        Entry entry;
+        in >> key >> entry.last_used >> entry.details;
+        entries.insert(key, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Mod details cache" << file.fileName() << "is damaged, mods will be read again";
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_entries = entries;
+}
+
+void ModDetailsCache::save()
+{
+    // our keys are only any good if the hashes of the files are remembered too
+    m_hashes->save();
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty)
+        return;
+
+    auto oldest = today() - s_max_unused_days;
+    for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+        if (iter->last_used < oldest)
+            iter = m_entries.erase(iter);
+        else
+            ++iter;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    out << s_cache_magic << s_cache_version << quint32(m_entries.size());
+    for (auto iter = m_entries.constBegin(); iter != m_entries.constEnd(); ++iter)
+        out << iter.key() << iter->last_used << iter->details;
+
+    try {
+        FS::write(m_cache_path, data);
+        m_dirty = false;
+    } catch (const Exception& e) {
+        qWarning() << "Failed to save the mod details cache:" << e.cause();
+    }
+}
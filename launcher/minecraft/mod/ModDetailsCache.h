@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+#include <optional>
+
+#include "ModDetails.h"
+
+namespace Hashing {
+class HashCache;
+}
+
+/**
+ * Remembers what was read from the metadata inside mod files, so we don't have to open the jars again.
+ *
+ * Entries are keyed by the SHA-1 of the file, so they are shared by every instance that has the same mod, and survive
+ * the file being moved or renamed. The hashes themselves come from the hash cache, which only has to stat files it
+ * already knows. All methods are thread safe.
+ */
+class ModDetailsCache {
+   public:
+    ModDetailsCache(QString cache_path, std::shared_ptr<Hashing::HashCache> hashes);
+    ~ModDetailsCache();
+
+    void load();
+    void save();
+
+    /// The details of the mod file at `path`, if we've seen a file with the same contents before.
+    /// Reads the file if the hash cache doesn't know it, so don't call it on the GUI thread.
+    std::optional<ModDetails> find(const QString& path);
+    /// Remember the details read from the mod file at `path`.
+    void insert(const QString& path, const ModDetails& details);
+
+   private:
+    struct Entry {
+        ModDetails details;
+        // when the entry was last used, in days since the epoch. Entries nobody used in a long while are dropped.
+        qint64 last_used = 0;
+    };
+
+    QByteArray fingerprint(const QString& path);
+
+   private:
+    QString m_cache_path;
+    std::shared_ptr<Hashing::HashCache> m_hashes;
+
+    QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    bool m_dirty = false;
+};
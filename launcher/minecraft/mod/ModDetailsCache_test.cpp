@@ -0,0 +1,106 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+
+#include "minecraft/mod/ModDetailsCache.h"
+#include "minecraft/mod/tasks/LocalModParseTask.h"
+#include "modplatform/helpers/HashCache.h"
+
+class ModDetailsCacheTest : public QObject {
+    Q_OBJECT
+
+    static ModDetails makeDetails(const QString& name)
+    {
+        ModDetails details;
+        details.mod_id = name.toLower();
+        details.name = name;
+        details.version = "1.2.3";
+        details.authors = QStringList{ "someone", "someone else" };
+        details.status = ModStatus::Installed;
+        return details;
+    }
+
+   private slots:
+    void test_sameContents()
+    {
+        QTemporaryDir dir;
+        auto hashes = std::make_shared<Hashing::HashCache>(FS::PathCombine(dir.path(), "hashes.dat"));
+        ModDetailsCache cache(FS::PathCombine(dir.path(), "moddetails.dat"), hashes);
+
+        auto path = FS::PathCombine(dir.path(), "one", "mod.jar");
+        auto copy = FS::PathCombine(dir.path(), "two", "renamed.jar.disabled");
+        FS::write(path, "not really a jar");
+        FS::write(copy, "not really a jar");
+
+        QVERIFY(!cache.find(path));
+        cache.insert(path, makeDetails("Mod"));
+
+        // any file with the same contents is the same mod
+        auto details = cache.find(copy);
+        QVERIFY(details);
+        QCOMPARE(details->name, QString("Mod"));
+        QCOMPARE(details->authors, makeDetails("Mod").authors);
+        // the status depends on the instance, not on the file
+        QCOMPARE(details->status, ModStatus::Unknown);
+
+        FS::write(copy, "a different mod");
+        QVERIFY(!cache.find(copy));
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        auto cache_path = FS::PathCombine(dir.path(), "moddetails.dat");
+        auto hashes_path = FS::PathCombine(dir.path(), "hashes.dat");
+        auto path = FS::PathCombine(dir.path(), "mod.jar");
+        FS::write(path, "not really a jar");
+
+        {
+            auto hashes = std::make_shared<Hashing::HashCache>(hashes_path);
+            ModDetailsCache cache(cache_path, hashes);
+            cache.insert(path, makeDetails("Saved"));
+            cache.save();
+        }
+
+        auto hashes = std::make_shared<Hashing::HashCache>(hashes_path);
+        hashes->load();
+        ModDetailsCache cache(cache_path, hashes);
+        cache.load();
+        // known without reading the file again
+        QVERIFY(hashes->find(path));
+        QCOMPARE(cache.find(path)->version, QString("1.2.3"));
+
+        auto data = FS::read(cache_path);
+        FS::write(cache_path, data.left(data.size() - 4));
+        ModDetailsCache damaged(cache_path, hashes);
+        damaged.load();
+        QVERIFY(!damaged.find(path));
+    }
+
+    void test_parseTask()
+    {
+        QTemporaryDir dir;
+        auto hashes = std::make_shared<Hashing::HashCache>(FS::PathCombine(dir.path(), "hashes.dat"));
+        auto cache = std::make_shared<ModDetailsCache>(FS::PathCombine(dir.path(), "moddetails.dat"), hashes);
+
+        QFileInfo mod(QFINDTESTDATA("testdata/supercoolmod.jar"));
+        QString parsed_name;
+        {
+            LocalModParseTask task(0, ResourceType::ZIPFILE, mod, cache);
+            task.start();
+            parsed_name = task.result()->details.name;
+        }
+        QCOMPARE(cache->find(mod.absoluteFilePath())->name, parsed_name);
+
+        // the next task takes what the cache has, without opening the jar
+        cache->insert(mod.absoluteFilePath(), makeDetails("From the cache"));
+        LocalModParseTask task(1, ResourceType::ZIPFILE, mod, cache);
+        task.start();
+        QCOMPARE(task.result()->details.name, QString("From the cache"));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsCacheTest)
+
+#include "ModDetailsCache_test.moc"
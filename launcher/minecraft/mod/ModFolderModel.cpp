@@ -44,6 +44,7 @@
 #include <QThreadPool>
 #include <QUrl>
 #include <QUuid>
+#include <QtConcurrent>
 #include <algorithm>
 
 #include "minecraft/mod/tasks/LocalModParseTask.h"
@@ -53,6 +54,18 @@ ModFolderModel::ModFolderModel(const QString &dir, bool is_indexed) : ResourceFo
 {
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_column_sort_keys = { SortType::ENABLED, SortType::NAME, SortType::VERSION, SortType::DATE };
+
+    m_details_save_timer.setSingleShot(true);
+    m_details_save_timer.setTimerType(Qt::VeryCoarseTimer);
+    m_details_save_timer.setInterval(5000);
+    connect(&m_details_save_timer, &QTimer::timeout, this, [this] {
+        auto cache = m_persistent_details_cache;
+        if (!cache)
+            return;
+        // it's a couple of files to write, not something for the GUI thread
+        auto saving = QtConcurrent::run(QThreadPool::globalInstance(), [cache] { cache->save(); });
+        Q_UNUSED(saving);
+    });
 }
 
 QVariant ModFolderModel::data(const QModelIndex &index, int role) const
@@ -158,7 +171,31 @@ Task* ModFolderModel::createUpdateTask()
 
 Task* ModFolderModel::createParseTask(Resource const& resource)
 {
-    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo());
+    return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo(), m_persistent_details_cache);
+}
+
+QString ModFolderModel::detailsCacheKey(Resource const& resource)
+{
+    auto name = resource.fileinfo().fileName();
+    if (name.endsWith(".disabled"))
+        name.chop(9);
+    return name;
+}
+
+void ModFolderModel::resolveResource(Resource::Ptr res)
+{
+    if (!res->shouldResolve())
+        return;
+
+    auto cached = m_details_cache.constFind(detailsCacheKey(*res));
+    if (cached != m_details_cache.constEnd() && cached->size == res->fileinfo().size() &&
+        cached->changed == res->dateTimeChanged().toMSecsSinceEpoch()) {
+        ModDetails details = *cached->details;
+        static_cast<Mod*>(res.get())->finishResolvingWithDetails(std::move(details));
+        return;
+    }
+
+    ResourceFolderModel::resolveResource(res);
 }
 
 bool ModFolderModel::uninstallMod(const QString& filename, bool preserve_metadata)
@@ -259,7 +296,18 @@ void ModFolderModel::onUpdateSucceeded()
 #endif
 
     applyUpdates(current_set, new_set, new_mods);
-    
+
+    // forget about the files that are gone
+    QSet<QString> cache_keys;
+    for (auto const& resource : m_resources)
+        cache_keys.insert(detailsCacheKey(*resource));
+    for (auto iter = m_details_cache.begin(); iter != m_details_cache.end();) {
+        if (cache_keys.contains(iter.key()))
+            ++iter;
+        else
+            iter = m_details_cache.erase(iter);
+    }
+
     m_current_update_task.reset();
 
     if (m_scheduled_update) {
@@ -286,8 +334,19 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     auto resource = find(mod_id);
 
     auto result = cast_task->result();
-    if (result && resource)
+    if (result && resource) {
+        if (resource->type() != ResourceType::FOLDER) {
+            auto details = std::make_shared<ModDetails>(result->details);
+            details->status = ModStatus::Unknown;
+            m_details_cache.insert(detailsCacheKey(*resource),
+                                   { resource->fileinfo().size(), resource->dateTimeChanged().toMSecsSinceEpoch(), details });
+        }
         resource->finishResolvingWithDetails(std::move(result->details));
+    }
+
+    // keep what we learned in case we don't get to exit cleanly, once all the mods are in
+    if (m_persistent_details_cache)
+        m_details_save_timer.start();
 
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
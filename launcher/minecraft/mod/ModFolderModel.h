@@ -36,14 +36,17 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QSet>
 #include <QString>
 #include <QDir>
 #include <QAbstractListModel>
+#include <QTimer>
 
 #include "Mod.h"
+#include "ModDetailsCache.h"
 #include "ResourceFolderModel.h"
 
 #include "minecraft/mod/tasks/ModFolderLoadTask.h"
@@ -83,6 +86,7 @@ public:
 
     [[nodiscard]] Task* createUpdateTask() override;
     [[nodiscard]] Task* createParseTask(Resource const&) override;
+    void resolveResource(Resource::Ptr res) override;
 
     bool installMod(QString file_path) { return ResourceFolderModel::installResource(file_path); }
     bool uninstallMod(const QString& filename, bool preserve_metadata = false);
@@ -97,6 +101,9 @@ public:
 
     QDir indexDir() { return { QString("%1/.index").arg(dir().absolutePath()) }; }
 
+    /// Look up and remember what's in the mod files in `cache`, instead of always opening them.
+    void setDetailsCache(std::shared_ptr<ModDetailsCache> cache) { m_persistent_details_cache = std::move(cache); }
+
     auto selectedMods(QModelIndexList& indexes) -> QList<Mod*>;
     auto allMods() -> QList<Mod*>;
 
@@ -110,4 +117,19 @@ slots:
 protected:
     bool m_is_indexed;
     bool m_first_folder_load = true;
+
+private:
+    /* What we got out of a mod file the last time we opened it, so we don't have to do it again while it stays the same. */
+    struct CachedDetails {
+        qint64 size = -1;
+        qint64 changed = 0;
+        std::shared_ptr<const ModDetails> details;
+    };
+    // Keyed by file name without the ".disabled", so enabling or disabling a mod doesn't make us open it again
+    static QString detailsCacheKey(Resource const&);
+
+    QHash<QString, CachedDetails> m_details_cache;
+    std::shared_ptr<ModDetailsCache> m_persistent_details_cache;
+    // saves the persistent cache once mods stopped coming in for a bit
+    QTimer m_details_save_timer;
 };
@@ -249,7 +249,8 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
             auto& new_resource = new_resources[kept];
             auto const& current_resource = m_resources[row];
 
-            if (new_resource->dateTimeChanged() == current_resource->dateTimeChanged()) {
+            if (new_resource->dateTimeChanged() == current_resource->dateTimeChanged() &&
+                new_resource->fileinfo().size() == current_resource->fileinfo().size()) {
                 // no significant change, ignore...
                 continue;
             }
@@ -268,6 +268,41 @@ slots:
             QCoreApplication::processEvents();
         }
     }
+
+    void test_reuseDetails()
+    {
+        QString file_mod = QFINDTESTDATA("testdata/supercoolmod.jar");
+
+        QTemporaryDir tmp;
+        ModFolderModel model(tmp.path());
+
+        {
+            EXEC_UPDATE_TASK(model.installMod(file_mod), QVERIFY)
+        }
+
+        while (model.hasPendingParseTasks()) {
+            QTest::qSleep(20);
+            QCoreApplication::processEvents();
+        }
+
+        QCOMPARE(model.size(), 1);
+        auto name = model.at(0)->name();
+        auto version = model.at(0)->version();
+
+        // disabling renames the file, but there's no need to open it again
+        auto path = FS::PathCombine(tmp.path(), "supercoolmod.jar");
+        QVERIFY(QFile::rename(path, path + ".disabled"));
+
+        {
+            EXEC_UPDATE_TASK(model.update(), QVERIFY)
+        }
+
+        QCOMPARE(model.size(), 1);
+        QVERIFY(!model.hasPendingParseTasks());
+        QVERIFY(!model.at(0)->enabled());
+        QCOMPARE(model.at(0)->name(), name);
+        QCOMPARE(model.at(0)->version(), version);
+    }
 };
 
 QTEST_GUILESS_MAIN(ResourceFolderModelTest)
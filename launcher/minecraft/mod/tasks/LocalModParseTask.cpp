@@ -338,11 +338,12 @@ ModDetails ReadLiteModInfo(QByteArray contents)
 
 }
 
-LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile):
+LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile, std::shared_ptr<ModDetailsCache> details_cache):
     Task(nullptr, false),
     m_token(token),
     m_type(type),
     m_modFile(modFile),
+    m_details_cache(std::move(details_cache)),
     m_result(new Result())
 {}
 
@@ -505,6 +506,16 @@ bool LocalModParseTask::abort()
 
 void LocalModParseTask::executeTask()
 {
+    // folders have no single file we could recognize them by
+    bool use_cache = m_details_cache && m_type != ResourceType::FOLDER;
+    if (use_cache) {
+        if (auto details = m_details_cache->find(m_modFile.absoluteFilePath())) {
+            m_result->details = *details;
+            emitSucceeded();
+            return;
+        }
+    }
+
     switch(m_type)
     {
         case ResourceType::ZIPFILE:
@@ -520,8 +531,12 @@ void LocalModParseTask::executeTask()
             break;
     }
 
-    if (m_aborted)
+    if (m_aborted) {
         emitAborted();
-    else
-        emitSucceeded();
+        return;
+    }
+
+    if (use_cache)
+        m_details_cache->insert(m_modFile.absoluteFilePath(), m_result->details);
+    emitSucceeded();
 }
@@ -5,6 +5,7 @@
 
 #include "minecraft/mod/Mod.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include "tasks/Task.h"
 
@@ -23,7 +24,7 @@ public:
     [[nodiscard]] bool canAbort() const override { return true; }
     bool abort() override;
 
-    LocalModParseTask(int token, ResourceType type, const QFileInfo & modFile);
+    LocalModParseTask(int token, ResourceType type, const QFileInfo & modFile, std::shared_ptr<ModDetailsCache> details_cache = nullptr);
     void executeTask() override;
 
     [[nodiscard]] int token() const { return m_token; }
@@ -37,6 +38,7 @@ private:
     int m_token;
     ResourceType m_type;
     QFileInfo m_modFile;
+    std::shared_ptr<ModDetailsCache> m_details_cache;
     ResultPtr m_result;
 
     bool m_aborted = false;
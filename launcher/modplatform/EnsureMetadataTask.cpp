@@ -3,6 +3,7 @@
 #include <MurmurHash2.h>
 #include <QDebug>
 
+#include "Application.h"
 #include "Json.h"
 
 #include "minecraft/mod/Mod.h"
@@ -21,28 +22,31 @@ static ModrinthAPI modrinth_api;
 static FlameAPI flame_api;
 
 EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::Provider prov)
-    : Task(nullptr), m_index_dir(dir), m_provider(prov), m_hashing_task(nullptr), m_current_task(nullptr)
+    : Task(nullptr), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
 {
-    auto hash_task = createNewHash(mod);
-    if (!hash_task)
-        return;
-    connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(hash_task->getResult(), mod); });
-    connect(hash_task.get(), &Task::failed, [this, hash_task, mod] { emitFail(mod, "", RemoveFromList::No); });
-    hash_task->start();
+    m_hashing_task = new ConcurrentTask(this, "MakeHashesTask", 10);
+    addHashTask(mod);
+
+    // nobody else is going to run it for a single mod, executeTask() waits for it if needed
+    m_hashing_task->start();
 }
 
 EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::Provider prov)
     : Task(nullptr), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
 {
     m_hashing_task = new ConcurrentTask(this, "MakeHashesTask", 10);
-    for (auto* mod : mods) {
-        auto hash_task = createNewHash(mod);
-        if (!hash_task)
-            continue;
-        connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(hash_task->getResult(), mod); });
-        connect(hash_task.get(), &Task::failed, [this, hash_task, mod] { emitFail(mod, "", RemoveFromList::No); });
-        m_hashing_task->addTask(hash_task);
-    }
+    for (auto* mod : mods)
+        addHashTask(mod);
+}
+
+void EnsureMetadataTask::addHashTask(Mod* mod)
+{
+    auto hash_task = createNewHash(mod);
+    if (!hash_task)
+        return;
+    connect(hash_task.get(), &Task::succeeded, [this, hash_task, mod] { m_mods.insert(hash_task->getResult(), mod); });
+    connect(hash_task.get(), &Task::failed, [this, hash_task, mod] { emitFail(mod, "", RemoveFromList::No); });
+    m_hashing_task->addTask(hash_task);
 }
 
 Hashing::Hasher::Ptr EnsureMetadataTask::createNewHash(Mod* mod)
@@ -87,6 +91,12 @@ void EnsureMetadataTask::executeTask()
 {
     setStatus(tr("Checking if mods have metadata..."));
 
+    // the hashes may still be on their way
+    if (m_hashing_task->isRunning()) {
+        connect(m_hashing_task, &Task::finished, this, &EnsureMetadataTask::executeTask);
+        return;
+    }
+
     for (auto* mod : m_mods) {
         if (!mod->valid()) {
             qDebug() << "Mod" << mod->name() << "is invalid!";
@@ -43,6 +43,7 @@ class EnsureMetadataTask : public Task {
     void emitFail(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
 
     // Hashes and stuff
+    void addHashTask(Mod*);
     auto createNewHash(Mod*) -> Hashing::Hasher::Ptr;
     auto getExistingHash(Mod*) -> QString;
 
@@ -3,12 +3,20 @@
 #include "Json.h"
 #include "net/Upload.h"
 
+#include "modplatform/flame/FlameAPI.h"
+#include "modplatform/modrinth/ModrinthAPI.h"
+
+static ModrinthAPI modrinth_api;
+static FlameAPI flame_api;
+
 Flame::FileResolvingTask::FileResolvingTask(const shared_qobject_ptr<QNetworkAccessManager>& network, Flame::Manifest& toProcess)
     : m_network(network), m_toProcess(toProcess)
 {}
 
 bool Flame::FileResolvingTask::abort()
 {
+    if (m_projectsJob)
+        return m_projectsJob->abort();
     if (m_dljob)
         return m_dljob->abort();
     return true;
@@ -37,10 +45,8 @@ void Flame::FileResolvingTask::executeTask()
 void Flame::FileResolvingTask::netJobFinished()
 {
     setProgress(1, 3);
-    int index = 0;
-    // job to check modrinth for blocked projects
-    auto job = new NetJob("Modrinth check", m_network);
-    blockedProjects = QMap<File *,QByteArray *>();
+    m_blocked.clear();
+    QStringList hashes;
     auto doc = Json::requireDocument(*result);
     auto array = Json::requireArray(doc.object()["data"]);
     for (QJsonValueRef file : array) {
@@ -50,87 +56,101 @@ void Flame::FileResolvingTask::netJobFinished()
            out.parseFromObject(Json::requireObject(file));
         } catch (const JSONValidationError& e) {
             qDebug() << "Blocked mod on curseforge" << out.fileName;
-            auto hash = out.hash;
-            if(!hash.isEmpty()) {
-                auto url = QString("https://api.modrinth.com/v2/version_file/%1?algorithm=sha1").arg(hash);
-                auto output = new QByteArray();
-                auto dl = Net::Download::makeByteArray(QUrl(url), output);
-                QObject::connect(dl.get(), &Net::Download::succeeded, [&out]() {
-                    out.resolved = true;
-                });
-
-                job->addNetAction(dl);
-                blockedProjects.insert(&out, output);
-            }
+            m_blocked.append(&out);
+            if (!out.hash.isEmpty())
+                hashes.append(out.hash);
         }
-        index++;
     }
-    connect(job, &NetJob::finished, this, &Flame::FileResolvingTask::modrinthCheckFinished);
 
-    job->start();
+    if (hashes.isEmpty()) {
+        modrinthCheckFinished();
+        return;
+    }
+
+    // look for all of them on modrinth at once
+    auto response = new QByteArray();
+    m_dljob = modrinth_api.currentVersions(hashes, "sha1", response);
+    connect(m_dljob.get(), &NetJob::succeeded, this, [this, response] {
+        QJsonObject versions;
+        try {
+            versions = Json::requireObject(Json::requireDocument(*response));
+        } catch (const JSONValidationError& e) {
+            qWarning() << "Couldn't read the modrinth versions of blocked mods:" << e.cause();
+            return;
+        }
+
+        for (auto out : m_blocked) {
+            if (out->hash.isEmpty() || !versions.contains(out->hash))
+                continue;
+            try {
+                // the file with the hash we asked for, or the primary one if the hashes aren't there
+                QUrl url;
+                for (auto file : Json::requireArray(Json::requireObject(versions, out->hash), "files")) {
+                    auto fileObj = Json::requireObject(file);
+                    if (Json::ensureString(Json::ensureObject(fileObj, "hashes"), "sha1") == out->hash) {
+                        url = Json::requireUrl(fileObj, "url");
+                        break;
+                    }
+                    if (Json::ensureBoolean(fileObj, QStringLiteral("primary"), false))
+                        url = Json::requireUrl(fileObj, "url");
+                }
+                if (url.isValid()) {
+                    out->url = url;
+                    out->resolved = true;
+                    qDebug() << "Found alternative on modrinth " << out->fileName;
+                }
+            } catch (const JSONValidationError& e) {
+                qWarning() << "Couldn't read the modrinth version of" << out->fileName << ":" << e.cause();
+            }
+        }
+    });
+    connect(m_dljob.get(), &NetJob::finished, this, &Flame::FileResolvingTask::modrinthCheckFinished);
+    m_dljob->start();
 }
 
 void Flame::FileResolvingTask::modrinthCheckFinished() {
     setProgress(2, 3);
-    qDebug() << "Finished with blocked mods : " << blockedProjects.size();
 
-    for (auto it = blockedProjects.keyBegin(); it != blockedProjects.keyEnd(); it++) {
-        auto &out = *it;
-        auto bytes = blockedProjects[out];
-        if (!out->resolved) {
-            delete bytes;
-            continue;
-        }
-        QJsonDocument doc = QJsonDocument::fromJson(*bytes);
-        auto obj = doc.object();
-        auto array = Json::requireArray(obj,"files");
-        for (auto file: array) {
-            auto fileObj = Json::requireObject(file);
-            auto primary = Json::requireBoolean(fileObj,"primary");
-            if (primary) {
-                out->url = Json::requireUrl(fileObj,"url");
-                qDebug() << "Found alternative on modrinth " << out->fileName;
-                break;
-            }
-        }
-        delete bytes;
-    }
-    //copy to an output list and filter out projects found on modrinth
-    auto block = new QList<File *>();
-    auto it = blockedProjects.keys();
-    std::copy_if(it.begin(), it.end(), std::back_inserter(*block), [](File *f) {
+    QList<File*> block;
+    std::copy_if(m_blocked.begin(), m_blocked.end(), std::back_inserter(block), [](File *f) {
         return !f->resolved;
     });
-    //Display not found mods early
-    if (!block->empty()) {
-        //blocked mods found, we need the slug for displaying.... we need another job :D !
-        auto slugJob = new NetJob("Slug Job", m_network);
-        auto slugs = QVector<QByteArray>(block->size());
-        auto index = 0;
-        for (auto fileInfo: *block) {
-            auto projectId = fileInfo->projectId;
-            slugs[index] = QByteArray();
-            auto url = QString("https://api.curseforge.com/v1/mods/%1").arg(projectId);
-            auto dl = Net::Download::makeByteArray(url, &slugs[index]);
-            slugJob->addNetAction(dl);
-            index++;
-        }
-        connect(slugJob, &NetJob::succeeded, this, [slugs, this, slugJob, block]() {
-            slugJob->deleteLater();
-            auto index = 0;
-            for (const auto &slugResult: slugs) {
-                auto json = QJsonDocument::fromJson(slugResult);
-                auto base = Json::requireString(Json::requireObject(Json::requireObject(Json::requireObject(json),"data"),"links"),
-                        "websiteUrl");
-                auto mod = block->at(index);
-                auto link = QString("%1/download/%2").arg(base, QString::number(mod->fileId));
-                mod->websiteUrl = link;
-                index++;
-            }
-            emitSucceeded();
-        });
-        slugJob->start();
-    } else {
+    qDebug() << "Finished with blocked mods : " << block.size();
+    if (block.empty()) {
         emitSucceeded();
+        return;
     }
+
+    // Blocked mods found, we need their pages for displaying them. One request for all the projects.
+    QStringList projectIds;
+    for (auto fileInfo : block) {
+        // a page that gets there, in case we can't get the real one
+        fileInfo->websiteUrl = QString("https://www.curseforge.com/projects/%1").arg(fileInfo->projectId);
+        projectIds.append(QString::number(fileInfo->projectId));
+    }
+    projectIds.removeDuplicates();
+
+    auto response = new QByteArray();
+    m_projectsJob = flame_api.getProjects(projectIds, response);
+    connect(m_projectsJob, &NetJob::succeeded, this, [this, response, block] {
+        try {
+            QHash<int, QString> websites;
+            auto projects = Json::requireArray(Json::requireObject(Json::requireDocument(*response)), "data");
+            for (auto project : projects) {
+                auto projectObj = Json::requireObject(project);
+                websites.insert(Json::requireInteger(projectObj, "id"), Json::requireString(Json::requireObject(projectObj, "links"), "websiteUrl"));
+            }
+            for (auto mod : block) {
+                if (websites.contains(mod->projectId))
+                    mod->websiteUrl = QString("%1/download/%2").arg(websites.value(mod->projectId), QString::number(mod->fileId));
+            }
+        } catch (const JSONValidationError& e) {
+            qWarning() << "Couldn't read the CurseForge projects of blocked mods:" << e.cause();
+        }
+    });
+    connect(m_projectsJob, &NetJob::finished, this, [this] {
+        // even without the real pages, the user can still find the files
+        emitSucceeded();
+    });
+    m_projectsJob->start();
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QPointer>
+
 #include "tasks/Task.h"
 #include "net/NetJob.h"
 #include "PackManifest.h"
@@ -32,9 +34,12 @@ private: /* data */
     Flame::Manifest m_toProcess;
     std::shared_ptr<QByteArray> result;
     NetJob::Ptr m_dljob;
+    /// the job getting the pages of the blocked mods, FlameAPI has it delete itself when it's done
+    QPointer<NetJob> m_projectsJob;
 
     void modrinthCheckFinished();
 
-    QMap<File *, QByteArray *> blockedProjects;
+    /// files CurseForge wouldn't give us a download URL for
+    QList<File *> m_blocked;
 };
 }
@@ -0,0 +1,219 @@
+#include "HashCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FileSystem.h"
+
+namespace Hashing {
+
+static const quint32 s_cache_magic = 0x48534843;  // "HSHC"
+static const quint32 s_cache_version = 2;
+
+HashCache::HashCache(QString cachePath) : m_cachePath(std::move(cachePath))
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::VeryCoarseTimer);
+    m_saveTimer.setInterval(5000);
+    QObject::connect(&m_saveTimer, &QTimer::timeout, &m_saveTimer, [this] {
+        // a slow disk is still busy with the last one, try again later
+        if (m_saving.isRunning()) {
+            m_saveTimer.start();
+            return;
+        }
+        m_saving = QtConcurrent::run(QThreadPool::globalInstance(), [this] { save(); });
+    });
+}
+
+HashCache::~HashCache()
+{
+    m_saveTimer.stop();
+    m_saving.waitForFinished();
+    save();
+}
+
+void HashCache::scheduleSave()
+{
+    // hashing happens on worker threads, the timer belongs to the thread that made the cache
+    QMetaObject::invokeMethod(
+        &m_saveTimer, [this] { m_saveTimer.start(); }, Qt::QueuedConnection);
+}
+
+auto HashCache::fileState(const QString& path) -> FileState
+{
+    FileState state;
+
+#ifdef Q_OS_UNIX
+    auto native_path = QFile::encodeName(path);
+    struct stat buf;
+    if (stat(native_path.constData(), &buf) != 0 || !S_ISREG(buf.st_mode))
+        return state;
+
+    state.exists = true;
+    state.size = buf.st_size;
+    state.fileId = (static_cast<quint64>(buf.st_dev) << 32) ^ static_cast<quint64>(buf.st_ino);
+    state.lastChanged = QFileInfo(path).lastModified().toUTC().toMSecsSinceEpoch();
+#else
+    QFileInfo info(path);
+    if (!info.isFile())
+        return state;
+
+    state.exists = true;
+    state.size = info.size();
+    state.lastChanged = info.lastModified().toUTC().toMSecsSinceEpoch();
+#endif
+
+    return state;
+}
+
+// add the digests `from` has to `into`
+static void merge(FileHashes& into, const FileHashes& from)
+{
+    if (from.algorithms & Algorithm::Sha1)
+        into.sha1 = from.sha1;
+    if (from.algorithms & Algorithm::Sha512)
+        into.sha512 = from.sha512;
+    if (from.algorithms & Algorithm::Md5)
+        into.md5 = from.md5;
+    if (from.algorithms & Algorithm::Murmur2)
+        into.murmur2 = from.murmur2;
+    into.algorithms |= from.algorithms;
+}
+
+auto HashCache::find(const QString& path, Algorithms algorithms) -> std::optional<FileHashes>
+{
+    auto key = QFileInfo(path).absoluteFilePath();
+    auto state = fileState(key);
+    if (!state.exists)
+        return {};
+
+    QMutexLocker locker(&m_mutex);
+    auto iter = m_entries.constFind(key);
+    if (iter == m_entries.constEnd() || !(iter->state == state) || (iter->hashes.algorithms & algorithms) != algorithms)
+        return {};
+    return iter->hashes;
+}
+
+auto HashCache::hash(const QString& path, Algorithms algorithms) -> std::optional<FileHashes>
+{
+    if (auto known = find(path, algorithms))
+        return known;
+
+    // look at the file before reading it, so a change while we read it invalidates what we computed
+    auto key = QFileInfo(path).absoluteFilePath();
+    auto state = fileState(key);
+    auto hashes = hashFile(key, algorithms);
+    if (!hashes || !state.exists)
+        return hashes;
+
+    FileHashes known;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto iter = m_entries.find(key);
+        if (iter != m_entries.end() && iter->state == state) {
+            merge(iter->hashes, *hashes);
+        } else {
+            iter = m_entries.insert(key, { state, *hashes });
+        }
+        m_dirty = true;
+        known = iter->hashes;
+    }
+    scheduleSave();
+    return known;
+}
+
+void HashCache::load()
+{
+    QFile file(m_cachePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_cache_magic || version != s_cache_version) {
+        qWarning() << "Ignoring hash cache with an unknown format:" << file.fileName();
+        return;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(int(count));
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.state.size >> entry.state.lastChanged >> entry.state.fileId;
+        quint32 algorithms;
+        in >> algorithms >> entry.hashes.sha1 >> entry.hashes.sha512 >> entry.hashes.md5 >> entry.hashes.murmur2;
+        entry.state.exists = true;
+        entry.hashes.algorithms = Algorithms(QFlag(int(algorithms)));
+        entries.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Hash cache" << file.fileName() << "is damaged, mods will be hashed again";
+        return;
+    }
+
+    // don't carry around the hashes of files that are gone, or that changed and would be hashed again anyway
+    bool dropped = false;
+    for (auto iter = entries.begin(); iter != entries.end();) {
+        if (fileState(iter.key()) == iter->state) {
+            ++iter;
+        } else {
+            iter = entries.erase(iter);
+            dropped = true;
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_entries = entries;
+    m_dirty = dropped;
+}
+
+void HashCache::save()
+{
+    // saves don't overlap, so what is on disk is never older than what was written before
+    QMutexLocker saveLocker(&m_saveMutex);
+
+    QHash<QString, Entry> entries;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return;
+        entries = m_entries;
+        m_dirty = false;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_6);
+
+    out << s_cache_magic << s_cache_version << quint32(entries.size());
+    for (auto iter = entries.constBegin(); iter != entries.constEnd(); ++iter) {
+        auto& entry = iter.value();
+        out << iter.key() << entry.state.size << entry.state.lastChanged << entry.state.fileId;
+        out << quint32(entry.hashes.algorithms) << entry.hashes.sha1 << entry.hashes.sha512 << entry.hashes.md5 << entry.hashes.murmur2;
+    }
+
+    try {
+        FS::write(m_cachePath, data);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to save the hash cache:" << e.cause();
+        QMutexLocker locker(&m_mutex);
+        m_dirty = true;
+    }
+}
+
+}  // namespace Hashing
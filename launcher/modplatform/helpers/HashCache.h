@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+#include "modplatform/helpers/MultiHash.h"
+
+namespace Hashing {
+
+/**
+ * Remembers the hashes of mod files across runs, so checking a few hundred mods for updates only reads the
+ * files that changed since the last time.
+ *
+ * Entries are keyed by absolute path and only trusted while the file still has the size, modification time and
+ * (where we can get it) inode it had when it was hashed. All methods are thread safe.
+ *
+ * Newly hashed files are written out a few seconds after the last one, on the thread pool. This needs the event loop of
+ * the thread that made the cache; without one, it's only written on save() and when it's destroyed.
+ */
+class HashCache {
+   public:
+    explicit HashCache(QString cachePath);
+    ~HashCache();
+
+    /// Reads the cache from disk, dropping entries for files that are gone or changed since
+    void load();
+    void save();
+
+    /// The hashes of the file, if `algorithms` are known and the file didn't change since. Never reads the file.
+    std::optional<FileHashes> find(const QString& path, Algorithms algorithms = AllAlgorithms);
+    /// The hashes of the file, reading it only if some of `algorithms` aren't known yet. Heavy, don't call it on the GUI
+    /// thread. What was known already about the file is kept, and comes back too.
+    std::optional<FileHashes> hash(const QString& path, Algorithms algorithms = AllAlgorithms);
+
+   private:
+    struct FileState {
+        bool exists = false;
+        qint64 size = -1;
+        qint64 lastChanged = 0;
+        quint64 fileId = 0;
+
+        bool operator==(const FileState& other) const
+        {
+            return size == other.size && lastChanged == other.lastChanged && fileId == other.fileId;
+        }
+    };
+    struct Entry {
+        FileState state;
+        FileHashes hashes;
+    };
+
+    static FileState fileState(const QString& path);
+
+    void scheduleSave();
+
+   private:
+    QString m_cachePath;
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+
+    QMutex m_saveMutex;
+    QTimer m_saveTimer;
+    QFuture<void> m_saving;
+};
+
+}  // namespace Hashing
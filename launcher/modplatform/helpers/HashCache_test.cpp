@@ -0,0 +1,122 @@
+#include <QDataStream>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/HashCache.h"
+
+#include <random>
+
+class HashCacheTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray makeContents(int size)
+    {
+        std::mt19937 rng(size);
+        QByteArray data(size, Qt::Uninitialized);
+        for (auto& c : data)
+            // plenty of the whitespace CurseForge leaves out
+            c = (rng() % 4 == 0) ? " \t\r\n"[rng() % 4] : char(rng() % 256);
+        return data;
+    }
+
+    static void touch(const QString& path, int secondsAgo)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-secondsAgo), QFileDevice::FileModificationTime));
+    }
+
+   private slots:
+    void test_cache()
+    {
+        QTemporaryDir dir;
+        auto cachePath = FS::PathCombine(dir.path(), "hashes.dat");
+        auto path = FS::PathCombine(dir.path(), "mods", "mod.jar");
+        FS::write(path, makeContents(1000));
+        touch(path, 60);
+
+        Hashing::HashCache cache(cachePath);
+        QVERIFY(!cache.find(path));
+        auto hashes = cache.hash(path);
+        QVERIFY(hashes);
+        QCOMPARE(cache.find(path)->sha512, hashes->sha512);
+        cache.save();
+
+        // it comes back from disk
+        Hashing::HashCache reloaded(cachePath);
+        reloaded.load();
+        QCOMPARE(reloaded.find(path)->sha1, hashes->sha1);
+
+        // same size, other contents and modification time
+        FS::write(path, makeContents(1000).replace(0, 1, "x"));
+        QVERIFY(!reloaded.find(path));
+        QVERIFY(reloaded.hash(path)->sha1 != hashes->sha1);
+
+        // removed files are dropped when loading
+        reloaded.save();
+        QFile::remove(path);
+        Hashing::HashCache pruned(cachePath);
+        pruned.load();
+        pruned.save();
+        QFile saved(cachePath);
+        QVERIFY(saved.open(QIODevice::ReadOnly));
+        QDataStream in(&saved);
+        in.setVersion(QDataStream::Qt_5_6);
+        quint32 magic, version, count;
+        in >> magic >> version >> count;
+        QCOMPARE(count, 0u);
+    }
+
+    void test_someAlgorithms()
+    {
+        QTemporaryDir dir;
+        auto cachePath = FS::PathCombine(dir.path(), "hashes.dat");
+        auto path = FS::PathCombine(dir.path(), "mod.jar");
+        auto contents = makeContents(1000);
+        FS::write(path, contents);
+
+        Hashing::HashCache cache(cachePath);
+        auto sha1 = cache.hash(path, Hashing::Algorithm::Sha1);
+        QVERIFY(sha1);
+        QCOMPARE(sha1->sha1, QCryptographicHash::hash(contents, QCryptographicHash::Sha1));
+        QVERIFY(sha1->sha512.isEmpty());
+        QVERIFY(cache.find(path, Hashing::Algorithm::Sha1));
+        QVERIFY(!cache.find(path));
+        cache.save();
+
+        // what isn't known yet is added to what is, also after a reload
+        Hashing::HashCache reloaded(cachePath);
+        reloaded.load();
+        QVERIFY(!reloaded.find(path, Hashing::Algorithm::Sha512));
+        auto both = reloaded.hash(path, Hashing::Algorithm::Sha512);
+        QVERIFY(both);
+        QCOMPARE(both->sha1, sha1->sha1);
+        QCOMPARE(both->sha512, QCryptographicHash::hash(contents, QCryptographicHash::Sha512));
+        QVERIFY(reloaded.find(path, Hashing::Algorithm::Sha1 | Hashing::Algorithm::Sha512));
+    }
+
+    void test_damagedCache()
+    {
+        QTemporaryDir dir;
+        auto cachePath = FS::PathCombine(dir.path(), "hashes.dat");
+        auto path = FS::PathCombine(dir.path(), "mod.jar");
+        FS::write(path, makeContents(100));
+
+        {
+            Hashing::HashCache cache(cachePath);
+            QVERIFY(cache.hash(path));
+        }
+        auto data = FS::read(cachePath);
+        FS::write(cachePath, data.left(data.size() - 8));
+
+        Hashing::HashCache cache(cachePath);
+        cache.load();
+        QVERIFY(!cache.find(path));
+    }
+};
+
+QTEST_GUILESS_MAIN(HashCacheTest)
+
+#include "HashCache_test.moc"
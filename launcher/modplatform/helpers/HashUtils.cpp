@@ -1,11 +1,11 @@
 #include "HashUtils.h"
 
 #include <QDebug>
-#include <QFile>
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QtConcurrent>
 
-#include "FileSystem.h"
-
-#include <MurmurHash2.h>
+#include "Application.h"
 
 namespace Hashing {
 
@@ -35,41 +35,33 @@ Hasher::Ptr createFlameHasher(QString file_path)
     return new FlameHasher(file_path);
 }
 
-void ModrinthHasher::executeTask()
+Hasher::Hasher(QString file_path, QString hash_type) : m_path(std::move(file_path)), m_hash_type(std::move(hash_type))
 {
-    QFile file(m_path);
+    connect(&m_watcher, &QFutureWatcher<std::optional<FileHashes>>::finished, this, [this] { hashed(m_watcher.result()); });
+}
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
+ModrinthHasher::ModrinthHasher(QString file_path)
+    : Hasher(file_path, ProviderCaps.hashType(ModPlatform::Provider::MODRINTH).first())
+{
+    setObjectName(QString("ModrinthHasher: %1").arg(file_path));
+}
 
-        emitFailed("Failed to open file for hashing.");
+void Hasher::executeTask()
+{
+    auto cache = APPLICATION->hashCache();
+    if (auto hashes = cache->find(m_path)) {
+        hashed(hashes);
         return;
     }
 
-    auto hash_type = ProviderCaps.hashType(ModPlatform::Provider::MODRINTH).first();
-    m_hash = ProviderCaps.hash(ModPlatform::Provider::MODRINTH, &file, hash_type);
-
-    file.close();
-
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-    }
+    setStatus(tr("Hashing %1").arg(QFileInfo(m_path).fileName()));
+    m_watcher.setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [cache, path = m_path] { return cache->hash(path); }));
 }
 
-void FlameHasher::executeTask()
+void Hasher::hashed(const std::optional<FileHashes>& hashes)
 {
-    // CF-specific
-    auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
-
-    std::ifstream file_stream(m_path.toStdString(), std::ifstream::binary);
-    // TODO: This is very heavy work, but apparently QtConcurrent can't use move semantics, so we can't boop this to another thread.
-    // How do we make this non-blocking then?
-    m_hash = QString::number(MurmurHash2(std::move(file_stream), 4 * MiB, should_filter_out));
+    if (hashes)
+        m_hash = hashes->get(m_hash_type);
 
     if (m_hash.isEmpty()) {
         emitFailed("Empty hash!");
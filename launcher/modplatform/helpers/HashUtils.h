@@ -1,43 +1,54 @@
 #pragma once
 
+#include <QFutureWatcher>
 #include <QString>
 
+#include <optional>
+
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/HashCache.h"
 #include "tasks/Task.h"
 
 namespace Hashing {
 
+/**
+ * Gets one hash of a file, from the hash cache if the file didn't change since it was last hashed.
+ * Otherwise the file is hashed on the global thread pool, and the task finishes once that's done.
+ */
 class Hasher : public Task {
    public:
     using Ptr = shared_qobject_ptr<Hasher>;
 
-    Hasher(QString file_path) : m_path(std::move(file_path)) {}
+    Hasher(QString file_path, QString hash_type);
 
     /* We can't really abort this task, but we can say we aborted and finish our thing quickly :) */
     bool abort() override { return true; }
 
-    void executeTask() override = 0;
+    void executeTask() override;
 
     QString getResult() const { return m_hash; };
     QString getPath() const { return m_path; };
 
+   private:
+    void hashed(const std::optional<FileHashes>& hashes);
+
    protected:
     QString m_hash;
     QString m_path;
+    QString m_hash_type;
+
+   private:
+    QFutureWatcher<std::optional<FileHashes>> m_watcher;
 };
 
 class FlameHasher : public Hasher {
    public:
-    FlameHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("FlameHasher: %1").arg(file_path)); }
-
-    void executeTask() override;
+    FlameHasher(QString file_path) : Hasher(file_path, "murmur2") { setObjectName(QString("FlameHasher: %1").arg(file_path)); }
 };
 
 class ModrinthHasher : public Hasher {
    public:
-    ModrinthHasher(QString file_path) : Hasher(file_path) { setObjectName(QString("ModrinthHasher: %1").arg(file_path)); }
-
-    void executeTask() override;
+    ModrinthHasher(QString file_path);
 };
 
 Hasher::Ptr createHasher(QString file_path, ModPlatform::Provider provider);
@@ -0,0 +1,177 @@
+#include "ModStore.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+
+#include "FileSystem.h"
+#include "net/ChecksumValidator.h"
+
+// pinned stored files by their absolute path, with how often they are pinned
+static QMutex s_pinMutex;
+static QHash<QString, int> s_pins;
+
+ModStore::ModStore(QString root) : m_root(std::move(root)) {}
+
+QString ModStore::algorithmName(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Sha1:
+            return "sha1";
+        case QCryptographicHash::Sha256:
+            return "sha256";
+        case QCryptographicHash::Sha512:
+            return "sha512";
+        default:
+            return {};
+    }
+}
+
+QString ModStore::blobPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto name = algorithmName(algorithm);
+    if (name.isEmpty() || hash.size() != QCryptographicHash::hashLength(algorithm))
+        return {};
+
+    auto hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(m_root, name, hex.left(2), hex);
+}
+
+bool ModStore::contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto path = blobPath(algorithm, hash);
+    return !path.isEmpty() && QFileInfo(path).isFile();
+}
+
+Net::Download::Ptr ModStore::makeDownload(QUrl url, QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    // the file sink only puts the file in place once it's complete, so a blob is never half-written
+    auto dl = Net::Download::makeFile(url, blobPath(algorithm, hash));
+    dl->addValidator(new Net::ChecksumValidator(algorithm, hash));
+    return dl;
+}
+
+bool ModStore::link(const Link& link) const
+{
+    auto blob = blobPath(link.algorithm, link.hash);
+    if (blob.isEmpty() || !QFileInfo(blob).isFile()) {
+        qWarning() << "Can't link" << link.target << "from the mod store, it doesn't have" << link.hash.toHex();
+        return false;
+    }
+
+    if (!FS::ensureFilePathExists(link.target))
+        return false;
+    if (QFileInfo::exists(link.target) && !QFile::remove(link.target))
+        return false;
+
+    // no symlinks, instances must keep working if the store gets cleaned up
+    if (FS::cloneFile(blob, link.target, FS::CloneLinks::HardOnly) == FS::CloneResult::Failed) {
+        qWarning() << "Failed to link" << link.target << "from the mod store";
+        return false;
+    }
+    return true;
+}
+
+void ModStore::addRef(const Link& link) const
+{
+    auto blob = blobPath(link.algorithm, link.hash);
+    if (blob.isEmpty())
+        return;
+
+    QFile refs(blob + ".refs");
+    if (!refs.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        // the file is in place, but the garbage collector may take it away from the store early
+        qWarning() << "Couldn't record that" << blob << "is used by" << link.target;
+        return;
+    }
+    refs.write(QFileInfo(link.target).absoluteFilePath().toUtf8() + '\n');
+}
+
+void ModStore::pin(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto blob = blobPath(algorithm, hash);
+    if (blob.isEmpty())
+        return;
+    QMutexLocker locker(&s_pinMutex);
+    s_pins[QFileInfo(blob).absoluteFilePath()]++;
+}
+
+void ModStore::unpin(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto blob = blobPath(algorithm, hash);
+    if (blob.isEmpty())
+        return;
+    QMutexLocker locker(&s_pinMutex);
+    auto iter = s_pins.find(QFileInfo(blob).absoluteFilePath());
+    if (iter != s_pins.end() && --*iter <= 0)
+        s_pins.erase(iter);
+}
+
+ModStore::GarbageStats ModStore::collectGarbage(qint64 gracePeriodSecs) const
+{
+    GarbageStats stats;
+    auto cutoff = QDateTime::currentDateTimeUtc().addSecs(-gracePeriodSecs);
+
+    QDirIterator iter(m_root, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (iter.hasNext()) {
+        auto blob = iter.next();
+        if (blob.endsWith(".refs"))
+            continue;
+
+        QFileInfo blobInfo(blob);
+        if (blobInfo.lastModified().toUTC() > cutoff) {
+            stats.kept++;
+            continue;
+        }
+
+        // still referenced if any of the places we put it in has a file of the same size in it, disabled or not
+        QFile refs(blob + ".refs");
+        QByteArrayList stillUsed;
+        if (refs.open(QIODevice::ReadOnly)) {
+            for (auto& line : refs.readAll().split('\n')) {
+                if (line.isEmpty() || stillUsed.contains(line))
+                    continue;
+                auto path = QString::fromUtf8(line);
+                for (auto& candidate : { path, path + ".disabled" }) {
+                    QFileInfo target(candidate);
+                    if (target.isFile() && target.size() == blobInfo.size()) {
+                        stillUsed.append(line);
+                        break;
+                    }
+                }
+            }
+            refs.close();
+        }
+
+        if (!stillUsed.isEmpty()) {
+            stats.kept++;
+            try {
+                FS::write(refs.fileName(), stillUsed.join('\n') + '\n');
+            } catch (const Exception& e) {
+                qWarning() << "Couldn't update" << refs.fileName() << ":" << e.cause();
+            }
+            continue;
+        }
+
+        // checked and removed in one go, so nothing can pin it in between
+        QMutexLocker locker(&s_pinMutex);
+        if (s_pins.contains(blobInfo.absoluteFilePath())) {
+            stats.kept++;
+            continue;
+        }
+        if (QFile::remove(blob)) {
+            QFile::remove(refs.fileName());
+            stats.removed++;
+            stats.freedBytes += blobInfo.size();
+        }
+    }
+
+    qDebug() << "Mod store garbage collection: kept" << stats.kept << "files, removed" << stats.removed << "freeing" << stats.freedBytes
+             << "bytes";
+    return stats;
+}
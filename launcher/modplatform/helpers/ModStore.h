@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QString>
+#include <QUrl>
+
+#include "net/Download.h"
+
+/**
+ * A content-addressed store for files downloaded by modpacks, shared by all instances.
+ *
+ * Files are stored once, by the hash the platform gives us for them, as `<root>/<algorithm>/<xx>/<hash>`.
+ * Instances get a reflink, hard link or copy of the stored file, never a symbolic link, so removing a
+ * file from the store never breaks an instance. Each stored file has a `.refs` file listing the paths
+ * it was handed out to, which is how the garbage collector knows what is still in use.
+ *
+ * Files an import is going to use are pinned while it runs, so the garbage collector can't take them away
+ * before they are linked and referenced.
+ */
+class ModStore {
+   public:
+    struct Link {
+        QCryptographicHash::Algorithm algorithm;
+        QByteArray hash;
+        QString target;
+    };
+
+    struct GarbageStats {
+        int kept = 0;
+        int removed = 0;
+        qint64 freedBytes = 0;
+    };
+
+    explicit ModStore(QString root = QStringLiteral("store/mods"));
+
+    /// Where the file with this hash is (or would be) stored. Empty if we can't store by this kind of hash.
+    QString blobPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    bool contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    /// A download into the store, verified against the hash
+    Net::Download::Ptr makeDownload(QUrl url, QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    /// Put the stored file at `link.target`, replacing whatever is there
+    bool link(const Link& link) const;
+
+    /// Remember the stored file is used at `link.target`. Only for where it's going to stay, not a staging folder.
+    void addRef(const Link& link) const;
+
+    /// Keep the garbage collector away from this stored file, whether it's there yet or not, until it's unpinned as
+    /// often as it was pinned. This goes for all stores in the launcher.
+    void pin(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+    void unpin(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    /**
+     * Remove stored files that aren't at any of the paths they were handed out to anymore, counting disabled mods
+     * (`<path>.disabled`) as still there. Pinned files and files younger than `gracePeriodSecs` are kept.
+     */
+    GarbageStats collectGarbage(qint64 gracePeriodSecs = 3600) const;
+
+   private:
+    static QString algorithmName(QCryptographicHash::Algorithm algorithm);
+
+   private:
+    QString m_root;
+};
@@ -0,0 +1,127 @@
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/ModStore.h"
+
+class ModStoreTest : public QObject {
+    Q_OBJECT
+
+    // What a finished download leaves in the store
+    static QByteArray addBlob(const ModStore& store, const QByteArray& contents)
+    {
+        auto hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+        FS::write(store.blobPath(QCryptographicHash::Sha1, hash), contents);
+        return hash;
+    }
+
+    static void makeOld(const QString& path)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-1), QFileDevice::FileModificationTime));
+    }
+
+   private slots:
+    void test_blobPath()
+    {
+        ModStore store("store");
+        auto hash = QByteArray::fromHex("bdf48ef6b5d0d23bbb02e17d04865216179f510a");
+        QCOMPARE(store.blobPath(QCryptographicHash::Sha1, hash), QString("store/sha1/bd/bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        // wrong length for the algorithm
+        QVERIFY(store.blobPath(QCryptographicHash::Sha512, hash).isEmpty());
+        // not something we store by
+        QVERIFY(store.blobPath(QCryptographicHash::Md5, QByteArray(16, 'a')).isEmpty());
+    }
+
+    void test_linkAndCollect()
+    {
+        QTemporaryDir dir;
+        ModStore store(FS::PathCombine(dir.path(), "store"));
+
+        auto shared = addBlob(store, "shared mod");
+        auto orphan = addBlob(store, "orphaned mod");
+        auto fresh = addBlob(store, "just downloaded");
+
+        auto first = FS::PathCombine(dir.path(), "first", "mods", "shared.jar");
+        auto second = FS::PathCombine(dir.path(), "second", "mods", "shared.jar");
+        ModStore::Link links[] = {
+            { QCryptographicHash::Sha1, shared, first },
+            { QCryptographicHash::Sha1, shared, second },
+            { QCryptographicHash::Sha1, orphan, FS::PathCombine(dir.path(), "third", "mods", "orphan.jar") },
+        };
+        for (auto& link : links) {
+            QVERIFY(store.link(link));
+            store.addRef(link);
+        }
+        QCOMPARE(FS::read(first), QByteArray("shared mod"));
+        QCOMPARE(FS::read(second), QByteArray("shared mod"));
+
+        QVERIFY(FS::deletePath(FS::PathCombine(dir.path(), "first")));
+        QVERIFY(FS::deletePath(FS::PathCombine(dir.path(), "third")));
+        makeOld(store.blobPath(QCryptographicHash::Sha1, shared));
+        makeOld(store.blobPath(QCryptographicHash::Sha1, orphan));
+
+        auto stats = store.collectGarbage();
+        QCOMPARE(stats.removed, 1);
+        QCOMPARE(stats.kept, 2);
+        QVERIFY(store.contains(QCryptographicHash::Sha1, shared));
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, orphan));
+        QVERIFY(store.contains(QCryptographicHash::Sha1, fresh));
+
+        // the instances don't depend on the store
+        QVERIFY(FS::deletePath(FS::PathCombine(dir.path(), "store")));
+        QCOMPARE(FS::read(second), QByteArray("shared mod"));
+    }
+
+    void test_disabledStillUsed()
+    {
+        QTemporaryDir dir;
+        ModStore store(FS::PathCombine(dir.path(), "store"));
+
+        auto hash = addBlob(store, "disabled mod");
+        auto target = FS::PathCombine(dir.path(), "instance", "mods", "mod.jar");
+        ModStore::Link link{ QCryptographicHash::Sha1, hash, target };
+        QVERIFY(store.link(link));
+        store.addRef(link);
+        makeOld(store.blobPath(QCryptographicHash::Sha1, hash));
+
+        // disabling a mod only renames it, that's no reason to drop it from the store
+        QVERIFY(QFile::rename(target, target + ".disabled"));
+        QCOMPARE(store.collectGarbage().removed, 0);
+
+        // and it's still known once it's enabled again
+        QVERIFY(QFile::rename(target + ".disabled", target));
+        QCOMPARE(store.collectGarbage().removed, 0);
+
+        QVERIFY(QFile::remove(target));
+        QCOMPARE(store.collectGarbage().removed, 1);
+    }
+
+    void test_pin()
+    {
+        QTemporaryDir dir;
+        ModStore store(FS::PathCombine(dir.path(), "store"));
+
+        // old and not used anywhere yet, like a file an import is about to link
+        auto hash = addBlob(store, "about to be linked");
+        makeOld(store.blobPath(QCryptographicHash::Sha1, hash));
+
+        // any store with the same root sees the pin
+        ModStore(FS::PathCombine(dir.path(), "store")).pin(QCryptographicHash::Sha1, hash);
+        store.pin(QCryptographicHash::Sha1, hash);
+        QCOMPARE(store.collectGarbage().removed, 0);
+
+        store.unpin(QCryptographicHash::Sha1, hash);
+        QCOMPARE(store.collectGarbage().removed, 0);
+
+        store.unpin(QCryptographicHash::Sha1, hash);
+        QCOMPARE(store.collectGarbage().removed, 1);
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, hash));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModStoreTest)
+
+#include "ModStore_test.moc"
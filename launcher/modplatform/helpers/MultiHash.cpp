@@ -0,0 +1,110 @@
+#include "MultiHash.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+
+#include <algorithm>
+#include <vector>
+
+#include <MurmurHash2.h>
+
+namespace Hashing {
+
+std::optional<Algorithm> algorithmFromName(const QString& name)
+{
+    if (name == "sha1")
+        return Algorithm::Sha1;
+    if (name == "sha512")
+        return Algorithm::Sha512;
+    if (name == "md5")
+        return Algorithm::Md5;
+    if (name == "murmur2")
+        return Algorithm::Murmur2;
+    return {};
+}
+
+QString FileHashes::get(const QString& type) const
+{
+    auto algorithm = algorithmFromName(type);
+    if (!algorithm || !algorithms.testFlag(*algorithm))
+        return {};
+
+    switch (*algorithm) {
+        case Algorithm::Sha1:
+            return sha1.toHex();
+        case Algorithm::Sha512:
+            return sha512.toHex();
+        case Algorithm::Md5:
+            return md5.toHex();
+        case Algorithm::Murmur2:
+            return QString::number(murmur2);
+    }
+    return {};
+}
+
+// Hand the whole file to `use` in one go: memory mapped if we can, read into memory otherwise
+template <typename Use>
+static bool withContents(const QString& path, Use use)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << path << "for hashing:" << file.errorString();
+        return false;
+    }
+
+    auto size = file.size();
+    if (size > 0) {
+        if (auto* data = file.map(0, size)) {
+            use(reinterpret_cast<const char*>(data), size);
+            file.unmap(data);
+            return true;
+        }
+    }
+
+    auto contents = file.readAll();
+    if (file.error() != QFileDevice::NoError) {
+        qWarning() << "Failed to read" << path << "for hashing:" << file.errorString();
+        return false;
+    }
+    use(contents.constData(), contents.size());
+    return true;
+}
+
+std::optional<FileHashes> hashFile(const QString& path, Algorithms algorithms)
+{
+    FileHashes hashes;
+    hashes.algorithms = algorithms;
+
+    bool ok = withContents(path, [&hashes, algorithms](const char* data, qint64 size) {
+        std::vector<std::pair<QCryptographicHash*, QByteArray*>> digests;
+        QCryptographicHash sha1(QCryptographicHash::Sha1);
+        QCryptographicHash sha512(QCryptographicHash::Sha512);
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        if (algorithms.testFlag(Algorithm::Sha1))
+            digests.emplace_back(&sha1, &hashes.sha1);
+        if (algorithms.testFlag(Algorithm::Sha512))
+            digests.emplace_back(&sha512, &hashes.sha512);
+        if (algorithms.testFlag(Algorithm::Md5))
+            digests.emplace_back(&md5, &hashes.md5);
+
+        // give every digest the same chunk while it is still in the CPU cache, instead of going over the file once per digest
+        const qint64 chunk_size = 256 * 1024;
+        for (qint64 pos = 0; pos < size && !digests.empty(); pos += chunk_size) {
+            auto length = int(std::min(size - pos, chunk_size));
+            for (auto& digest : digests)
+                digest.first->addData(data + pos, length);
+        }
+        for (auto& digest : digests)
+            *digest.second = digest.first->result();
+
+        if (algorithms.testFlag(Algorithm::Murmur2))
+            hashes.murmur2 = CurseForgeFingerprint(reinterpret_cast<const unsigned char*>(data), std::size_t(size));
+    });
+
+    if (!ok)
+        return {};
+    return hashes;
+}
+
+}  // namespace Hashing
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFlags>
+#include <QString>
+
+#include <optional>
+
+namespace Hashing {
+
+enum class Algorithm {
+    Sha1 = 0x1,
+    Sha512 = 0x2,
+    Md5 = 0x4,
+    /// CurseForge's fingerprint: murmur2 with seed 1 over the file, minus whitespace
+    Murmur2 = 0x8,
+};
+Q_DECLARE_FLAGS(Algorithms, Algorithm)
+
+/// The algorithm the mod platforms call `name` ("sha1", "sha512", "md5" or "murmur2")
+std::optional<Algorithm> algorithmFromName(const QString& name);
+
+struct FileHashes {
+    /// Which of the digests below were computed
+    Algorithms algorithms;
+
+    QByteArray sha1;
+    QByteArray sha512;
+    QByteArray md5;
+    quint32 murmur2 = 0;
+
+    /// The hash in the form the platforms use for `type`. Empty if unknown or not computed.
+    QString get(const QString& type) const;
+};
+
+/// Compute the digests of the file, all from the same single read of it. Heavy, don't call it on the GUI thread.
+std::optional<FileHashes> hashFile(const QString& path, Algorithms algorithms);
+
+}  // namespace Hashing
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Hashing::Algorithms)
+
+namespace Hashing {
+static const Algorithms AllAlgorithms = Algorithm::Sha1 | Algorithm::Sha512 | Algorithm::Md5 | Algorithm::Murmur2;
+}
@@ -0,0 +1,96 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <MurmurHash2.h>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/MultiHash.h"
+
+#include <random>
+
+class MultiHashTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray makeContents(int size)
+    {
+        std::mt19937 rng(size);
+        QByteArray data(size, Qt::Uninitialized);
+        for (auto& c : data)
+            // plenty of the whitespace CurseForge leaves out
+            c = (rng() % 4 == 0) ? " \t\r\n"[rng() % 4] : char(rng() % 256);
+        return data;
+    }
+
+   private slots:
+    void test_hashFile_data()
+    {
+        QTest::addColumn<int>("size");
+
+        QTest::newRow("empty") << 0;
+        QTest::newRow("short") << 3;
+        QTest::newRow("unaligned") << 4099;
+        QTest::newRow("several reads") << 3 * 1024 * 1024 + 5;
+    }
+    void test_hashFile()
+    {
+        QFETCH(int, size);
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "mod.jar");
+        auto contents = makeContents(size);
+        FS::write(path, contents);
+
+        auto hashes = Hashing::hashFile(path, Hashing::AllAlgorithms);
+        QVERIFY(hashes);
+        QCOMPARE(hashes->sha1, QCryptographicHash::hash(contents, QCryptographicHash::Sha1));
+        QCOMPARE(hashes->sha512, QCryptographicHash::hash(contents, QCryptographicHash::Sha512));
+        QCOMPARE(hashes->md5, QCryptographicHash::hash(contents, QCryptographicHash::Md5));
+
+        auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
+        std::ifstream file_stream(path.toStdString(), std::ifstream::binary);
+        QCOMPARE(hashes->murmur2, MurmurHash2(std::move(file_stream), 4 * MiB, should_filter_out));
+        QCOMPARE(hashes->get("murmur2"), QString::number(hashes->murmur2));
+        QCOMPARE(Hashing::hashFile(path, Hashing::Algorithm::Murmur2)->murmur2, hashes->murmur2);
+
+        // only what was asked for
+        auto sha1 = Hashing::hashFile(path, Hashing::Algorithm::Sha1);
+        QVERIFY(sha1);
+        QCOMPARE(sha1->sha1, hashes->sha1);
+        QVERIFY(sha1->get("sha512").isEmpty());
+        QVERIFY(!Hashing::hashFile(FS::PathCombine(dir.path(), "missing.jar"), Hashing::Algorithm::Sha1));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_fingerprint_data()
+    {
+        QTest::addColumn<bool>("mapped");
+
+        QTest::newRow("two reads") << false;
+        QTest::newRow("mapped, one pass") << true;
+    }
+    void benchmark_fingerprint()
+    {
+        QFETCH(bool, mapped);
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "big.jar");
+        FS::write(path, makeContents(100 * MiB));
+
+        quint32 fingerprint = 0;
+        QBENCHMARK
+        {
+            if (mapped) {
+                fingerprint = Hashing::hashFile(path, Hashing::Algorithm::Murmur2)->murmur2;
+            } else {
+                auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
+                fingerprint = MurmurHash2(std::ifstream(path.toStdString(), std::ifstream::binary), 4 * MiB, should_filter_out);
+            }
+        }
+        QVERIFY(fingerprint != 0);
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(MultiHashTest)
+
+#include "MultiHash_test.moc"
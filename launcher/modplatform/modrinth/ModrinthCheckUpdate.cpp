@@ -15,6 +15,8 @@ static ModPlatform::ProviderCapabilities ProviderCaps;
 
 bool ModrinthCheckUpdate::abort()
 {
+    if (m_hashing_task && m_hashing_task->isRunning())
+        return m_hashing_task->abort();
     if (m_net_job)
         return m_net_job->abort();
     return true;
@@ -30,13 +32,10 @@ void ModrinthCheckUpdate::executeTask()
     setStatus(tr("Preparing mods for Modrinth..."));
     setProgress(0, 3);
 
-    QHash<QString, Mod*> mappings;
-
     // Create all hashes
-    QStringList hashes;
     auto best_hash_type = ProviderCaps.hashType(ModPlatform::Provider::MODRINTH).first();
 
-    ConcurrentTask hashing_task(this, "MakeModrinthHashesTask", 10);
+    m_hashing_task = new ConcurrentTask(this, "MakeModrinthHashesTask", 10);
     for (auto* mod : m_mods) {
         if (!mod->enabled()) {
             emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
@@ -50,30 +49,33 @@ void ModrinthCheckUpdate::executeTask()
         // (though it will rarely happen, if at all)
         if (mod->metadata()->hash_format != best_hash_type) {
             auto hash_task = Hashing::createModrinthHasher(mod->fileinfo().absoluteFilePath());
-            connect(hash_task.get(), &Task::succeeded, [&] {
-                QString hash (hash_task->getResult());
-                hashes.append(hash);
-                mappings.insert(hash, mod);
+            connect(hash_task.get(), &Task::succeeded, this, [this, hash_task, mod] {
+                QString hash(hash_task->getResult());
+                m_hashes.append(hash);
+                m_mappings.insert(hash, mod);
             });
-            connect(hash_task.get(), &Task::failed, [this, hash_task] { failed("Failed to generate hash"); });
-            hashing_task.addTask(hash_task);
+            connect(hash_task.get(), &Task::failed, this, [this, mod] { emit checkFailed(mod, tr("Failed to generate hash")); });
+            m_hashing_task->addTask(hash_task);
         } else {
-            hashes.append(hash);
-            mappings.insert(hash, mod);
+            m_hashes.append(hash);
+            m_mappings.insert(hash, mod);
         }
     }
 
-    QEventLoop loop;
-    connect(&hashing_task, &Task::finished, [&loop]{ loop.quit(); });
-    hashing_task.start();
-    loop.exec();
+    // files that didn't change since the last check come straight from the hash cache, the rest is hashed off the GUI thread
+    connect(m_hashing_task, &Task::succeeded, this, &ModrinthCheckUpdate::checkVersions);
+    connect(m_hashing_task, &Task::aborted, this, &ModrinthCheckUpdate::emitAborted);
+    m_hashing_task->start();
+}
 
-    auto* response = new QByteArray();
-    auto job = api.latestVersions(hashes, best_hash_type, m_game_versions, m_loaders, response);
+void ModrinthCheckUpdate::checkVersions()
+{
+    auto best_hash_type = ProviderCaps.hashType(ModPlatform::Provider::MODRINTH).first();
 
-    QEventLoop lock;
+    auto* response = new QByteArray();
+    auto job = api.latestVersions(m_hashes, best_hash_type, m_game_versions, m_loaders, response);
 
-    connect(job.get(), &Task::succeeded, this, [this, response, &mappings, best_hash_type, job] {
+    connect(job.get(), &Task::succeeded, this, [this, response, best_hash_type, job] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -89,17 +91,17 @@ void ModrinthCheckUpdate::executeTask()
         setProgress(2, 3);
 
         try {
-            for (auto hash : mappings.keys()) {
+            for (auto hash : m_mappings.keys()) {
                 auto project_obj = doc[hash].toObject();
 
                 // If the returned project is empty, but we have Modrinth metadata,
                 // it means this specific version is not available
                 if (project_obj.isEmpty()) {
-                    qDebug() << "Mod " << mappings.find(hash).value()->name() << " got an empty response.";
+                    qDebug() << "Mod " << m_mappings.find(hash).value()->name() << " got an empty response.";
                     qDebug() << "Hash: " << hash;
 
                     emit checkFailed(
-                        mappings.find(hash).value(),
+                        m_mappings.find(hash).value(),
                         tr("No valid version found for this mod. It's probably unavailable for the current game version / mod loader."));
 
                     continue;
@@ -126,13 +128,13 @@ void ModrinthCheckUpdate::executeTask()
                     qCritical() << "Modrinth mod without download url!";
                     qCritical() << project_ver.fileName;
 
-                    emit checkFailed(mappings.find(hash).value(), tr("Mod has an empty download URL"));
+                    emit checkFailed(m_mappings.find(hash).value(), tr("Mod has an empty download URL"));
 
                     continue;
                 }
 
-                auto mod_iter = mappings.find(hash);
-                if (mod_iter == mappings.end()) {
+                auto mod_iter = m_mappings.find(hash);
+                if (mod_iter == m_mappings.end()) {
                     qCritical() << "Failed to remap mod from Modrinth!";
                     continue;
                 }
@@ -165,15 +167,14 @@ void ModrinthCheckUpdate::executeTask()
         }
     });
 
-    connect(job.get(), &Task::finished, &lock, &QEventLoop::quit);
+    connect(job.get(), &Task::finished, this, [this] {
+        m_net_job = nullptr;
+        emitSucceeded();
+    });
 
     setStatus(tr("Waiting for the API response from Modrinth..."));
     setProgress(1, 3);
 
     m_net_job = job.get();
     job->start();
-
-    lock.exec();
-
-    emitSucceeded();
 }
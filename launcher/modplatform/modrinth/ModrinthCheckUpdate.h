@@ -3,6 +3,7 @@
 #include "Application.h"
 #include "modplatform/CheckUpdateTask.h"
 #include "net/NetJob.h"
+#include "tasks/ConcurrentTask.h"
 
 class ModrinthCheckUpdate : public CheckUpdateTask {
     Q_OBJECT
@@ -19,5 +20,12 @@ class ModrinthCheckUpdate : public CheckUpdateTask {
     void executeTask() override;
 
    private:
+    void checkVersions();
+
+   private:
+    ConcurrentTask* m_hashing_task = nullptr;
     NetJob* m_net_job = nullptr;
+
+    QStringList m_hashes;
+    QHash<QString, Mod*> m_mappings;
 };
@@ -20,8 +20,13 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 
+#include <memory>
+
 #include "toml.h"
 #include "FileSystem.h"
 
@@ -30,6 +35,132 @@
 
 namespace Packwiz {
 
+namespace {
+
+// What we know about the files of an index directory, so that lookups don't have to list and parse all of them
+struct IndexDirectory {
+    struct File {
+        qint64 modified = 0;
+        qint64 size = -1;
+        bool parsed = false;
+        QString modId;
+        // everything in the file, if it was read since it last changed
+        std::shared_ptr<const V1::Mod> contents;
+    };
+
+    // modification time of the directory when it was listed. Adding, removing or renaming files changes it.
+    qint64 dirModified = -1;
+    QHash<QString, File> files;
+    // lower case file name -> file name
+    QHash<QString, QString> lowerCaseNames;
+    // mod id -> file name, only complete once every file was parsed
+    QHash<QString, QString> byModId;
+    bool byModIdComplete = false;
+};
+
+QMutex s_index_mutex;
+QHash<QString, IndexDirectory> s_indexes;
+
+}  // namespace
+
+static auto modifiedTime(const QFileInfo& info) -> qint64
+{
+    return info.exists() ? info.lastModified().toUTC().toMSecsSinceEpoch() : 0;
+}
+
+// The index of the directory, listed again if it changed since. Needs s_index_mutex to be held.
+static auto indexFor(const QDir& index_dir) -> IndexDirectory&
+{
+    auto path = index_dir.absolutePath();
+    auto& index = s_indexes[path];
+
+    auto dir_modified = modifiedTime(QFileInfo(path));
+    if (dir_modified == index.dirModified)
+        return index;
+
+    QHash<QString, IndexDirectory::File> files;
+    for (auto& info : QDir(path).entryInfoList(QDir::Filter::Files)) {
+        IndexDirectory::File file;
+        file.modified = modifiedTime(info);
+        file.size = info.size();
+
+        // no need to parse the files that didn't change again
+        auto known = index.files.constFind(info.fileName());
+        if (known != index.files.constEnd() && known->modified == file.modified && known->size == file.size)
+            file = *known;
+
+        files.insert(info.fileName(), file);
+    }
+
+    index.dirModified = dir_modified;
+    index.files = files;
+    index.lowerCaseNames.clear();
+    for (auto iter = index.files.constBegin(); iter != index.files.constEnd(); ++iter)
+        index.lowerCaseNames.insert(iter.key().toLower(), iter.key());
+    index.byModId.clear();
+    index.byModIdComplete = false;
+
+    return index;
+}
+
+// Keep the index of the directory in line with a change we made to one of its files, so it doesn't need to be
+// listed again. `dir_modified_before` is the modification time of the directory from right before the change.
+static void indexFileChanged(const QDir& index_dir, qint64 dir_modified_before, const QString& file_name, bool removed, const QString& mod_id = {})
+{
+    QMutexLocker locker(&s_index_mutex);
+
+    auto path = index_dir.absolutePath();
+    auto index = s_indexes.find(path);
+    // someone else changed the directory since we last listed it, we'll have to list it again anyway
+    if (index == s_indexes.end() || index->dirModified != dir_modified_before)
+        return;
+
+    for (auto iter = index->byModId.begin(); iter != index->byModId.end();) {
+        if (iter.value() == file_name)
+            iter = index->byModId.erase(iter);
+        else
+            ++iter;
+    }
+
+    if (removed) {
+        index->files.remove(file_name);
+        index->lowerCaseNames.remove(file_name.toLower());
+    } else {
+        QFileInfo info(index_dir.absoluteFilePath(file_name));
+        IndexDirectory::File file;
+        file.modified = modifiedTime(info);
+        file.size = info.size();
+        file.parsed = true;
+        file.modId = mod_id;
+        index->files.insert(file_name, file);
+        index->lowerCaseNames.insert(file_name.toLower(), file_name);
+        if (!mod_id.isEmpty())
+            index->byModId.insert(mod_id, file_name);
+    }
+
+    index->dirModified = modifiedTime(QFileInfo(path));
+}
+
+// Remember what was read from a file, unless it changed in the meantime. Needs s_index_mutex to be held.
+static void indexFileRead(IndexDirectory& index, const QString& file_name, const QFileInfo& info, const V1::Mod& mod)
+{
+    auto file = index.files.find(file_name);
+    if (file == index.files.end() || file->modified != modifiedTime(info) || file->size != info.size())
+        return;
+
+    file->parsed = true;
+    file->modId = mod.mod_id().toString();
+    file->contents = std::make_shared<const V1::Mod>(mod);
+    if (index.byModIdComplete && !file->modId.isEmpty())
+        index.byModId.insert(file->modId, file_name);
+}
+
+static void forgetIndex(const QDir& index_dir)
+{
+    QMutexLocker locker(&s_index_mutex);
+    s_indexes.remove(index_dir.absolutePath());
+}
+
 auto getRealIndexName(QDir& index_dir, QString normalized_fname, bool should_find_match) -> QString
 {
     QFile index_file(index_dir.absoluteFilePath(normalized_fname));
@@ -37,12 +168,11 @@ auto getRealIndexName(QDir& index_dir, QString normalized_fname, bool should_fin
     QString real_fname = normalized_fname;
     if (!index_file.exists()) {
         // Tries to get similar entries
-        for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-            if (!QString::compare(normalized_fname, file_name, Qt::CaseInsensitive)) {
-                real_fname = file_name;
-                break;
-            }
-        }
+        QMutexLocker locker(&s_index_mutex);
+        auto& names = indexFor(index_dir).lowerCaseNames;
+        auto similar = names.constFind(normalized_fname.toLower());
+        if (similar != names.constEnd())
+            real_fname = similar.value();
 
         if(should_find_match && !QString::compare(normalized_fname, real_fname, Qt::CaseSensitive)){
             qCritical() << "Could not find a match for a valid metadata file!";
@@ -140,6 +270,7 @@ void V1::updateModIndex(QDir& index_dir, Mod& mod)
 
     auto normalized_fname = indexFileName(mod.slug);
     auto real_fname = getRealIndexName(index_dir, normalized_fname);
+    auto dir_modified = modifiedTime(QFileInfo(index_dir.absolutePath()));
 
     QFile index_file(index_dir.absoluteFilePath(real_fname));
 
@@ -188,6 +319,10 @@ void V1::updateModIndex(QDir& index_dir, Mod& mod)
 
     index_file.flush();
     index_file.close();
+
+    if (real_fname != normalized_fname)
+        indexFileChanged(index_dir, dir_modified, real_fname, true);
+    indexFileChanged(index_dir, dir_modified, normalized_fname, false, mod.mod_id().toString());
 }
 
 void V1::deleteModIndex(QDir& index_dir, QString& mod_slug)
@@ -204,33 +339,54 @@ void V1::deleteModIndex(QDir& index_dir, QString& mod_slug)
         return;
     }
 
+    auto dir_modified = modifiedTime(QFileInfo(index_dir.absolutePath()));
     if (!index_file.remove()) {
         qWarning() << QString("Failed to remove metadata for mod %1!").arg(mod_slug);
+        return;
     }
+    indexFileChanged(index_dir, dir_modified, real_fname, true);
 }
 
 void V1::deleteModIndex(QDir& index_dir, QVariant& mod_id)
 {
-    for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-        auto mod = getIndexForMod(index_dir, file_name);
-
-        if (mod.mod_id() == mod_id) {
-            deleteModIndex(index_dir, mod.name);
-            break;
-        }
-    }
+    auto mod = getIndexForMod(index_dir, mod_id);
+    // the slug of a mod found by id is its file name
+    if (mod.isValid())
+        deleteModIndex(index_dir, mod.slug);
 }
 
 auto V1::getIndexForMod(QDir& index_dir, QString slug) -> Mod
 {
-    Mod mod;
-
     auto normalized_fname = indexFileName(slug);
     auto real_fname = getRealIndexName(index_dir, normalized_fname, true);
     if (real_fname.isEmpty())
         return {};
 
-    QFile index_file(index_dir.absoluteFilePath(real_fname));
+    // files we already read, and that didn't change since, don't need to be parsed again
+    QFileInfo info(index_dir.absoluteFilePath(real_fname));
+    {
+        QMutexLocker locker(&s_index_mutex);
+        auto& index = indexFor(index_dir);
+        auto file = index.files.constFind(real_fname);
+        if (file != index.files.constEnd() && file->contents && file->modified == modifiedTime(info) && file->size == info.size()) {
+            Mod mod = *file->contents;
+            mod.slug = slug;
+            return mod;
+        }
+    }
+
+    auto mod = readIndexFile(info.absoluteFilePath(), slug);
+
+    QMutexLocker locker(&s_index_mutex);
+    indexFileRead(indexFor(index_dir), real_fname, info, mod);
+    return mod;
+}
+
+auto V1::readIndexFile(const QString& path, QString slug) -> Mod
+{
+    Mod mod;
+
+    QFile index_file(path);
 
     if (!index_file.open(QIODevice::ReadOnly)) {
         qWarning() << QString("Failed to open mod metadata for %1").arg(slug);
@@ -247,7 +403,7 @@ auto V1::getIndexForMod(QDir& index_dir, QString slug) -> Mod
     index_file.close();
 
     if (!table) {
-        qWarning() << QString("Could not open file %1!").arg(normalized_fname);
+        qWarning() << QString("Could not open file %1!").arg(path);
         qWarning() << "Reason: " << QString(errbuf);
         return {};
     }
@@ -303,13 +459,60 @@ auto V1::getIndexForMod(QDir& index_dir, QString slug) -> Mod
     return mod;
 }
 
+// The file with the metadata for the mod with the given id, parsing only the files we don't know the id of yet
+static auto findIndexFile(QDir& index_dir, const QString& mod_id) -> QString
+{
+    QMutexLocker locker(&s_index_mutex);
+    auto& index = indexFor(index_dir);
+
+    // files edited in place don't change the directory, so check each of them before trusting what we know
+    for (auto iter = index.files.begin(); iter != index.files.end(); ++iter) {
+        QFileInfo info(index_dir.absoluteFilePath(iter.key()));
+        auto modified = modifiedTime(info);
+        if (iter->modified == modified && iter->size == info.size())
+            continue;
+        *iter = {};
+        iter->modified = modified;
+        iter->size = info.size();
+        index.byModIdComplete = false;
+    }
+
+    if (!index.byModIdComplete) {
+        index.byModId.clear();
+        for (auto iter = index.files.begin(); iter != index.files.end(); ++iter) {
+            if (!iter->parsed) {
+                QFileInfo info(index_dir.absoluteFilePath(iter.key()));
+                auto mod = V1::readIndexFile(info.absoluteFilePath(), iter.key());
+                iter->modId = mod.mod_id().toString();
+                iter->parsed = true;
+                indexFileRead(index, iter.key(), info, mod);
+            }
+            if (!iter->modId.isEmpty())
+                index.byModId.insert(iter->modId, iter.key());
+        }
+        index.byModIdComplete = true;
+    }
+
+    return index.byModId.value(mod_id);
+}
+
 auto V1::getIndexForMod(QDir& index_dir, QVariant& mod_id) -> Mod
 {
-    for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-        auto mod = getIndexForMod(index_dir, file_name);
+    auto id = mod_id.toString();
+    if (id.isEmpty())
+        return {};
 
-        if (mod.mod_id() == mod_id)
+    for (int attempt = 0; attempt < 2; attempt++) {
+        auto file_name = findIndexFile(index_dir, id);
+        if (file_name.isEmpty())
+            return {};
+
+        auto mod = getIndexForMod(index_dir, file_name);
+        if (mod.mod_id().toString() == id)
             return mod;
+
+        // the file was changed in place, which doesn't change the directory. Look at everything again.
+        forgetIndex(index_dir);
     }
 
     return {};
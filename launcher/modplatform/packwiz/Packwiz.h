@@ -97,6 +97,11 @@ class V1 {
      * If the mod doesn't have a metadata, it simply returns an empty Mod object.
      * */
     static auto getIndexForMod(QDir& index_dir, QVariant& mod_id) -> Mod;
+
+    /* Parses the metadata in a .pw.toml file. The slug is given as-is to the resulting Mod object.
+     * If the file can't be read, it returns an empty Mod object.
+     * */
+    static auto readIndexFile(const QString& path, QString slug) -> Mod;
 };
 
 } // namespace Packwiz
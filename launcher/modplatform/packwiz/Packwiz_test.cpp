@@ -17,11 +17,16 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QDateTime>
 #include <QTemporaryDir>
 #include <QTest>
 
 #include "Packwiz.h"
 
+#ifdef Q_OS_UNIX
+#include <utime.h>
+#endif
+
 class PackwizTest : public QObject {
     Q_OBJECT
 
@@ -80,6 +85,57 @@ class PackwizTest : public QObject {
         QCOMPARE(metadata.file_id, 3509043);
         QCOMPARE(metadata.project_id, 327154);
     }
+
+    void lookupById()
+    {
+        QTemporaryDir tmp;
+        QDir index_dir(tmp.path());
+        QDir source(QFINDTESTDATA("testdata"));
+        for (auto& file_name : source.entryList(QDir::Files))
+            QVERIFY(QFile::copy(source.absoluteFilePath(file_name), index_dir.absoluteFilePath(file_name)));
+
+        QVariant modrinth_id("kYq5qkSL");
+        QVariant flame_id(327154);
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, modrinth_id).name, "Borderless Mining");
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, flame_id).name, "Screenshot to Clipboard (Fabric)");
+
+        // written by us
+        auto mod = Packwiz::V1::getIndexForMod(index_dir, flame_id);
+        mod.slug = "screenshot-to-clipboard-fabric";
+        mod.project_id = 42;
+        Packwiz::V1::updateModIndex(index_dir, mod);
+        QVariant new_id(42);
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, new_id).name, "Screenshot to Clipboard (Fabric)");
+        QVERIFY(!Packwiz::V1::getIndexForMod(index_dir, flame_id).isValid());
+
+        // edited in place, which leaves the directory alone. Same size, so only the modification time gives it away.
+        QFile edited(index_dir.absoluteFilePath("borderless-mining.pw.toml"));
+        QVERIFY(edited.open(QIODevice::ReadWrite));
+        auto contents = edited.readAll().replace("mod-id = \"kYq5qkSL\"", "mod-id = \"aBcDeFgH\"");
+        QVERIFY(edited.seek(0));
+        QCOMPARE(edited.write(contents), qint64(contents.size()));
+        QVERIFY(edited.setFileTime(QDateTime::currentDateTime().addSecs(3600), QFileDevice::FileModificationTime));
+        edited.close();
+        QVariant edited_id("aBcDeFgH");
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, edited_id).name, "Borderless Mining");
+        QVERIFY(!Packwiz::V1::getIndexForMod(index_dir, modrinth_id).isValid());
+
+#ifdef Q_OS_UNIX
+        // added behind our back, with a name that only matches without looking at the case.
+        // The directory gets a modification time other than the one our own change left it with.
+        QVERIFY(QFile::copy(source.absoluteFilePath("borderless-mining.pw.toml"), index_dir.absoluteFilePath("Other-Mod.pw.toml")));
+        auto past = QDateTime::currentDateTime().addSecs(-3600).toSecsSinceEpoch();
+        struct utimbuf times { time_t(past), time_t(past) };
+        QCOMPARE(utime(QFile::encodeName(index_dir.absolutePath()).constData(), &times), 0);
+        QCOMPARE(Packwiz::getRealIndexName(index_dir, "other-mod.pw.toml"), "Other-Mod.pw.toml");
+#endif
+
+        // removed by id
+        Packwiz::V1::deleteModIndex(index_dir, new_id);
+        QVERIFY(!QFile::exists(index_dir.absoluteFilePath("screenshot-to-clipboard-fabric.pw.toml")));
+        QVERIFY(!Packwiz::V1::getIndexForMod(index_dir, new_id).isValid());
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, edited_id).name, "Borderless Mining");
+    }
 };
 
 QTEST_GUILESS_MAIN(PackwizTest)
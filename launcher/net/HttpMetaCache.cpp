@@ -38,12 +38,45 @@
 #include "Json.h"
 
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QtConcurrent>
 
 #include <QDebug>
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+/*
+ * The index is kept in a binary journal next to the old JSON index ("<index>.journal").
+ *
+ * It starts with a header (magic, format version), followed by length-prefixed records. A record
+ * either puts an entry (replacing any previous one for the same base and path) or removes one.
+ * Saving only appends the records for entries that changed since the last save, and the whole
+ * file is rewritten (compacted) once it holds too many dead records.
+ *
+ * A record that was only partially written (crash, full disk...) is dropped when loading, and the
+ * journal gets compacted on the next save.
+ */
+static const quint32 s_journal_magic = 0x504d4343;  // "PMCC"
+static const quint32 s_journal_version = 3;
+
+enum class JournalOp : quint8 { Put = 1, Remove = 2 };
+
+// Size of the chunks files are read in when hashing them.
+static const qint64 s_hash_chunk_size = 1024 * 1024;
+
+// Compact when there's more than this many records, and more than twice as many as live entries.
+static const int s_min_compaction_records = 4096;
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
@@ -52,6 +85,9 @@ auto MetaEntry::getFullPath() -> QString
 
 HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
 {
+    if (!m_index_file.isNull())
+        m_journal_file = m_index_file + ".journal";
+
     saveBatchingTimer.setSingleShot(true);
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
 
@@ -80,60 +116,184 @@ auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPt
     return {};
 }
 
-auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
+auto HttpMetaCache::localFileInfo(const QString& path) -> LocalFileInfo
 {
-    auto entry = getEntry(base, resource_path);
-    // it's not present? generate a default stale entry
-    if (!entry) {
-        return staleEntry(base, resource_path);
-    }
+    LocalFileInfo info;
+
+#ifdef Q_OS_UNIX
+    // One stat() gives us everything, including what QFileInfo won't tell us (the inode).
+    auto native_path = QFile::encodeName(path);
+    struct stat buf;
+    if (stat(native_path.constData(), &buf) != 0 || !S_ISREG(buf.st_mode) || access(native_path.constData(), R_OK) != 0)
+        return info;
+
+    info.exists = true;
+    info.size = buf.st_size;
+    info.file_id = (static_cast<quint64>(buf.st_dev) << 32) ^ static_cast<quint64>(buf.st_ino);
+    info.last_changed = QFileInfo(path).lastModified().toUTC().toMSecsSinceEpoch();
+#else
+    QFileInfo finfo(path);
+    if (!finfo.isFile() || !finfo.isReadable())
+        return info;
+
+    info.exists = true;
+    info.size = finfo.size();
+    info.last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
+#endif
+
+    return info;
+}
+
+auto HttpMetaCache::hashFile(const QString& path) -> QString
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly))
+        return {};
+
+    // Feed the hash a chunk at a time, so huge files don't have to fit in memory.
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QByteArray buffer(s_hash_chunk_size, Qt::Uninitialized);
+    qint64 read;
+    while ((read = input.read(buffer.data(), buffer.size())) > 0)
+        hash.addData(buffer.constData(), read);
+
+    if (read < 0)
+        return {};
 
-    auto& selected_base = m_entries[base];
-    QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
-    QFileInfo finfo(real_path);
+    return hash.result().toHex().constData();
+}
 
+auto HttpMetaCache::revalidate(MetaEntryPtr entry, const QString& expected_etag, const LocalFileInfo& info) -> Revalidation
+{
     // is the file really there? if not -> stale
-    if (!finfo.isFile() || !finfo.isReadable()) {
-        // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
-        return staleEntry(base, resource_path);
-    }
+    if (!info.exists)
+        return Revalidation::Stale;
 
-    if (!expected_etag.isEmpty() && expected_etag != entry->etag) {
-        // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
-        return staleEntry(base, resource_path);
-    }
+    // if the etag doesn't match expected, we disown the entry
+    if (!expected_etag.isEmpty() && expected_etag != entry->etag)
+        return Revalidation::Stale;
 
-    // if the file changed, check md5sum
-    qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
-    if (file_last_changed != entry->local_changed_timestamp) {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
-        if (entry->md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
-            return staleEntry(base, resource_path);
-        }
+    // the size changed, no need to look at the contents to know they changed too
+    if (entry->local_size >= 0 && entry->local_size != info.size)
+        return Revalidation::Stale;
+
+    // if the file changed (or was replaced), check md5sum
+    if (info.last_changed != entry->local_changed_timestamp)
+        return Revalidation::NeedsHash;
+    if (entry->local_file_id != 0 && info.file_id != 0 && entry->local_file_id != info.file_id)
+        return Revalidation::NeedsHash;
+
+    return Revalidation::Valid;
+}
 
-        // md5sums matched... keep entry and save the new state to file
-        entry->local_changed_timestamp = file_last_changed;
+auto HttpMetaCache::acceptEntry(MetaEntryPtr entry, const LocalFileInfo& info) -> MetaEntryPtr
+{
+    if (entry->local_changed_timestamp != info.last_changed || entry->local_size != info.size || entry->local_file_id != info.file_id) {
+        // the contents checked out... keep entry and save the new state to file
+        entry->local_changed_timestamp = info.last_changed;
+        entry->local_size = info.size;
+        entry->local_file_id = info.file_id;
+        markDirty(entry->baseId, entry->relativePath);
         SaveEventually();
     }
 
     // Get rid of old entries, to prevent cache problems
     auto current_time = QDateTime::currentSecsSinceEpoch();
-    if (entry->isExpired(current_time - ( file_last_changed / 1000 ))) {
+    if (entry->isExpired(current_time - (info.last_changed / 1000))) {
         qWarning() << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
-        return staleEntry(base, resource_path);
+        return disownEntry(entry->baseId, entry->relativePath);
     }
 
     // entry passed all the checks we cared about.
-    entry->basePath = getBasePath(base);
+    entry->basePath = getBasePath(entry->baseId);
     return entry;
 }
 
+auto HttpMetaCache::disownEntry(const QString& base, const QString& resource_path) -> MetaEntryPtr
+{
+    m_entries[base].entry_list.remove(resource_path);
+    markDirty(base, resource_path);
+    return staleEntry(base, resource_path);
+}
+
+auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
+{
+    auto entry = getEntry(base, resource_path);
+    // it's not present? generate a default stale entry
+    if (!entry) {
+        return staleEntry(base, resource_path);
+    }
+
+    QString real_path = FS::PathCombine(m_entries[base].base_path, resource_path);
+    auto info = localFileInfo(real_path);
+
+    switch (revalidate(entry, expected_etag, info)) {
+        case Revalidation::Stale:
+            return disownEntry(base, resource_path);
+        case Revalidation::NeedsHash:
+            if (hashFile(real_path) != entry->md5sum)
+                return disownEntry(base, resource_path);
+            break;
+        case Revalidation::Valid:
+            break;
+    }
+
+    return acceptEntry(entry, info);
+}
+
+void HttpMetaCache::resolveEntryAsync(QString base,
+                                      QString resource_path,
+                                      QString expected_etag,
+                                      QObject* context,
+                                      std::function<void(MetaEntryPtr)> callback)
+{
+    QPointer<QObject> guard(context);
+    auto deliver = [guard, callback](MetaEntryPtr entry) {
+        if (guard)
+            callback(entry);
+    };
+
+    auto entry = getEntry(base, resource_path);
+    if (!entry) {
+        deliver(staleEntry(base, resource_path));
+        return;
+    }
+
+    QString real_path = FS::PathCombine(m_entries[base].base_path, resource_path);
+    auto info = localFileInfo(real_path);
+
+    switch (revalidate(entry, expected_etag, info)) {
+        case Revalidation::Stale:
+            deliver(disownEntry(base, resource_path));
+            return;
+        case Revalidation::Valid:
+            deliver(acceptEntry(entry, info));
+            return;
+        case Revalidation::NeedsHash:
+            break;
+    }
+
+    // Only the hashing leaves this thread. The cache itself is only touched here.
+    auto watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, entry, info, expected_etag, deliver] {
+        watcher->deleteLater();
+
+        // the entry was replaced (or dropped) while we were busy
+        if (getEntry(entry->baseId, entry->relativePath) != entry) {
+            deliver(resolveEntry(entry->baseId, entry->relativePath, expected_etag));
+            return;
+        }
+
+        if (watcher->result() != entry->md5sum) {
+            deliver(disownEntry(entry->baseId, entry->relativePath));
+            return;
+        }
+
+        deliver(acceptEntry(entry, info));
+    });
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), &HttpMetaCache::hashFile, real_path));
+}
+
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
     if (!m_entries.contains(stale_entry->baseId)) {
@@ -146,7 +306,15 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
         return false;
     }
 
+    // remember what the file looked like, so we can tell cheaply whether it changed later on
+    auto info = localFileInfo(stale_entry->getFullPath());
+    if (info.exists) {
+        stale_entry->local_size = info.size;
+        stale_entry->local_file_id = info.file_id;
+    }
+
     m_entries[stale_entry->baseId].entry_list[stale_entry->relativePath] = stale_entry;
+    markDirty(stale_entry->baseId, stale_entry->relativePath);
     SaveEventually();
 
     return true;
@@ -158,10 +326,16 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->stale = true;
+    markDirty(entry->baseId, entry->relativePath);
     SaveEventually();
     return true;
 }
 
+void HttpMetaCache::markDirty(const QString& base, const QString& resource_path)
+{
+    m_dirty.insert({ base, resource_path });
+}
+
 auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
     auto foo = new MetaEntry();
@@ -199,9 +373,97 @@ void HttpMetaCache::Load()
     if (m_index_file.isNull())
         return;
 
+    if (loadJournal())
+        return;
+
+    // No usable journal. If there's an index from an older version, bring it over.
+    if (!loadLegacyIndex())
+        return;
+
+    qDebug() << "[HttpMetaCache]" << "Migrating" << m_index_file << "to" << m_journal_file;
+    if (writeSnapshot())
+        QFile::remove(m_index_file);
+}
+
+auto HttpMetaCache::loadJournal() -> bool
+{
+    QFile journal(m_journal_file);
+    if (!journal.open(QIODevice::ReadOnly))
+        return false;
+
+    auto data = journal.readAll();
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != s_journal_magic || version < 2 || version > s_journal_version) {
+        qWarning() << "[HttpMetaCache]" << "Ignoring journal with an unknown format:" << m_journal_file;
+        return false;
+    }
+
+    int records = 0;
+    bool torn = false;
+    while (!in.atEnd()) {
+        QByteArray payload;
+        in >> payload;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "[HttpMetaCache]" << "Dropping a partially written record at the end of" << m_journal_file;
+            torn = true;
+            break;
+        }
+        records++;
+
+        QDataStream record(payload);
+        record.setVersion(QDataStream::Qt_5_6);
+
+        quint8 op;
+        QString base, path;
+        record >> op >> base >> path;
+
+        // nothing ever wrote anything else, so the journal is damaged from here on
+        if (record.status() != QDataStream::Ok || (op != quint8(JournalOp::Put) && op != quint8(JournalOp::Remove))) {
+            qWarning() << "[HttpMetaCache]" << "Dropping the rest of" << m_journal_file << "after a damaged record";
+            torn = true;
+            break;
+        }
+
+        if (static_cast<JournalOp>(op) == JournalOp::Remove) {
+            if (m_entries.contains(base))
+                m_entries[base].entry_list.remove(path);
+            continue;
+        }
+
+        auto foo = new MetaEntry();
+        foo->baseId = base;
+        foo->relativePath = path;
+        record >> foo->md5sum >> foo->etag >> foo->local_changed_timestamp >> foo->remote_changed_timestamp >> foo->is_eternal >>
+            foo->current_age >> foo->max_age;
+        if (version >= 3)
+            record >> foo->local_size >> foo->local_file_id;
+
+        if (record.status() != QDataStream::Ok || !m_entries.contains(base)) {
+            delete foo;
+            continue;
+        }
+
+        // presumed innocent until closer examination
+        foo->stale = false;
+
+        m_entries[base].entry_list[path] = MetaEntryPtr(foo);
+    }
+
+    m_journal_records = records;
+    // records are only ever appended in the current format
+    m_needs_snapshot = torn || version != s_journal_version;
+    return true;
+}
+
+auto HttpMetaCache::loadLegacyIndex() -> bool
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
-        return;
+        return false;
 
     QJsonDocument json = QJsonDocument::fromJson(index.readAll());
 
@@ -210,7 +472,7 @@ void HttpMetaCache::Load()
     // check file version first
     auto version_val = Json::ensureString(root, "version");
     if (version_val != "1")
-        return;
+        return false;
 
     // read the entry array
     auto array = Json::ensureArray(root, "entries");
@@ -241,6 +503,8 @@ void HttpMetaCache::Load()
 
         entrymap.entry_list[foo->relativePath] = MetaEntryPtr(foo);
     }
+
+    return true;
 }
 
 void HttpMetaCache::SaveEventually()
@@ -252,44 +516,118 @@ void HttpMetaCache::SaveEventually()
 
 void HttpMetaCache::SaveNow()
 {
-    if (m_index_file.isNull())
+    if (m_journal_file.isNull())
+        return;
+
+    if (!m_needs_snapshot && m_dirty.isEmpty())
+        return;
+
+    int live_entries = 0;
+    for (auto const& group : m_entries)
+        live_entries += group.entry_list.size();
+
+    if (m_needs_snapshot || m_journal_records + m_dirty.size() > std::max(s_min_compaction_records, 2 * live_entries)) {
+        writeSnapshot();
         return;
+    }
+
+    if (!appendToJournal()) {
+        // whatever is on disk is not trustworthy anymore, start over
+        writeSnapshot();
+    }
+}
 
-    qDebug() << "[HttpMetaCache]" << "Saving metacache with" << m_entries.size() << "entries";
+void HttpMetaCache::writeRecord(QByteArray& out, const MetaEntry* entry)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record.setVersion(QDataStream::Qt_5_6);
+
+    record << static_cast<quint8>(JournalOp::Put) << entry->baseId << entry->relativePath << entry->md5sum << entry->etag
+           << entry->local_changed_timestamp << entry->remote_changed_timestamp << entry->is_eternal << entry->current_age << entry->max_age
+           << entry->local_size << entry->local_file_id;
+
+    QDataStream stream(&out, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << payload;
+}
+
+void HttpMetaCache::writeRemoveRecord(QByteArray& out, const QString& base, const QString& resource_path)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record.setVersion(QDataStream::Qt_5_6);
+
+    record << static_cast<quint8>(JournalOp::Remove) << base << resource_path;
+
+    QDataStream stream(&out, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << payload;
+}
 
-    QJsonObject toplevel;
-    Json::writeString(toplevel, "version", "1");
+auto HttpMetaCache::writeSnapshot() -> bool
+{
+    QByteArray data;
+    {
+        QDataStream header(&data, QIODevice::WriteOnly);
+        header.setVersion(QDataStream::Qt_5_6);
+        header << s_journal_magic << s_journal_version;
+    }
 
-    QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
+    int records = 0;
+    for (auto const& group : m_entries) {
+        for (auto const& entry : group.entry_list) {
             // do not save stale entries. they are dead.
-            if (entry->stale) {
+            if (entry->stale)
                 continue;
-            }
-
-            QJsonObject entryObj;
-            Json::writeString(entryObj, "base", entry->baseId);
-            Json::writeString(entryObj, "path", entry->relativePath);
-            Json::writeString(entryObj, "md5sum", entry->md5sum);
-            Json::writeString(entryObj, "etag", entry->etag);
-            entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->local_changed_timestamp)));
-            if (!entry->remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp", QJsonValue(entry->remote_changed_timestamp));
-            if (entry->isEternal()) {
-                entryObj.insert("eternal", true);
-            } else {
-                entryObj.insert("current_age", QJsonValue(double(entry->current_age)));
-                entryObj.insert("max_age", QJsonValue(double(entry->max_age)));
-            }
-            entriesArr.append(entryObj);
+
+            writeRecord(data, entry.get());
+            records++;
         }
     }
-    toplevel.insert("entries", entriesArr);
+
+    qDebug() << "[HttpMetaCache]" << "Compacting metacache journal with" << records << "entries";
 
     try {
-        Json::write(toplevel, m_index_file);
+        FS::write(m_journal_file, data);
     } catch (const Exception& e) {
         qWarning() << e.what();
+        return false;
     }
+
+    m_journal_records = records;
+    m_needs_snapshot = false;
+    m_dirty.clear();
+    return true;
+}
+
+auto HttpMetaCache::appendToJournal() -> bool
+{
+    QByteArray data;
+    for (auto const& key : m_dirty) {
+        MetaEntryPtr entry;
+        auto group = m_entries.constFind(key.first);
+        if (group != m_entries.constEnd())
+            entry = group->entry_list.value(key.second);
+
+        if (entry && !entry->stale)
+            writeRecord(data, entry.get());
+        else
+            writeRemoveRecord(data, key.first, key.second);
+    }
+
+    QFile journal(m_journal_file);
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "[HttpMetaCache]" << "Failed to open" << m_journal_file << "for writing:" << journal.errorString();
+        return false;
+    }
+
+    if (journal.write(data) != data.size() || !journal.flush()) {
+        qWarning() << "[HttpMetaCache]" << "Failed to append to" << m_journal_file << ":" << journal.errorString();
+        return false;
+    }
+
+    m_journal_records += m_dirty.size();
+    m_dirty.clear();
+    return true;
 }
@@ -36,8 +36,11 @@
 #pragma once
 
 #include <QMap>
+#include <QPair>
+#include <QSet>
 #include <QString>
 #include <QTimer>
+#include <functional>
 #include <memory>
 
 class HttpMetaCache;
@@ -84,6 +87,9 @@ class MetaEntry {
     QString etag;
 
     qint64 local_changed_timestamp = 0;
+    // cheap fingerprint of the local file, to tell whether it changed without hashing it
+    qint64 local_size = -1;
+    quint64 local_file_id = 0;
     QString remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 current_age = 0;
     qint64 max_age = 0;
@@ -108,6 +114,14 @@ class HttpMetaCache : public QObject {
     // get the entry from cache and verify that it isn't stale (within reason)
     auto resolveEntry(QString base, QString resource_path, QString expected_etag = QString()) -> MetaEntryPtr;
 
+    // same as resolveEntry, but if the file has to be hashed to verify it, that happens on the thread pool.
+    // `callback` is called on this object's thread, unless `context` is gone by then.
+    void resolveEntryAsync(QString base,
+                           QString resource_path,
+                           QString expected_etag,
+                           QObject* context,
+                           std::function<void(MetaEntryPtr)> callback);
+
     // add a previously resolved stale entry
     auto updateEntry(MetaEntryPtr stale_entry) -> bool;
 
@@ -129,6 +143,35 @@ class HttpMetaCache : public QObject {
     // create a new stale entry, given the parameters
     auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
+    struct LocalFileInfo {
+        bool exists = false;
+        qint64 last_changed = 0;
+        qint64 size = -1;
+        quint64 file_id = 0;
+    };
+    static auto localFileInfo(const QString& path) -> LocalFileInfo;
+    static auto hashFile(const QString& path) -> QString;
+
+    enum class Revalidation { Valid, Stale, NeedsHash };
+    // cheap checks only, this never reads the file
+    auto revalidate(MetaEntryPtr entry, const QString& expected_etag, const LocalFileInfo& info) -> Revalidation;
+    // the entry checked out, record what the file looks like now and check its age
+    auto acceptEntry(MetaEntryPtr entry, const LocalFileInfo& info) -> MetaEntryPtr;
+    auto disownEntry(const QString& base, const QString& resource_path) -> MetaEntryPtr;
+
+    // remember that the entry at (base, resource_path) needs to be written out on the next save
+    void markDirty(const QString& base, const QString& resource_path);
+
+    // binary journal, see HttpMetaCache.cpp for the format
+    auto loadJournal() -> bool;
+    auto writeSnapshot() -> bool;
+    auto appendToJournal() -> bool;
+    static void writeRecord(QByteArray& out, const MetaEntry* entry);
+    static void writeRemoveRecord(QByteArray& out, const QString& base, const QString& resource_path);
+
+    // version "1" JSON index, only read to migrate old caches
+    auto loadLegacyIndex() -> bool;
+
     struct EntryMap {
         QString base_path;
         QMap<QString, MetaEntryPtr> entry_list;
@@ -136,5 +179,13 @@ class HttpMetaCache : public QObject {
 
     QMap<QString, EntryMap> m_entries;
     QString m_index_file;
+    QString m_journal_file;
     QTimer saveBatchingTimer;
+
+    // entries changed since the last save, as (base, resource path) pairs
+    QSet<QPair<QString, QString>> m_dirty;
+    // number of records currently in the journal file, live or not
+    int m_journal_records = 0;
+    // the journal is missing or damaged, and has to be rewritten from scratch
+    bool m_needs_snapshot = true;
 };
@@ -0,0 +1,227 @@
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "net/HttpMetaCache.h"
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    static void addEntry(HttpMetaCache& cache, QString path, QString md5)
+    {
+        auto entry = cache.resolveEntry("general", path);
+        entry->setMD5Sum(md5);
+        entry->setETag("\"" + md5 + "\"");
+        entry->setLocalChangedTimestamp(1234);
+        entry->makeEternal(true);
+        entry->setStale(false);
+        cache.updateEntry(entry);
+    }
+
+   private slots:
+    void test_migrateLegacyIndex()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+
+        FS::write(index_path, R"({
+            "version": "1",
+            "entries": [
+                { "base": "general", "path": "a/b.json", "md5sum": "abc", "etag": "\"abc\"", "last_changed_timestamp": 42.0,
+                  "current_age": 10.0, "max_age": 20.0 },
+                { "base": "general", "path": "c.json", "md5sum": "def", "etag": "", "last_changed_timestamp": 43.0, "eternal": true },
+                { "base": "unknown", "path": "d.json", "md5sum": "ghi", "etag": "", "last_changed_timestamp": 44.0, "eternal": true }
+            ]
+        })");
+
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+
+            QVERIFY(!QFile::exists(index_path));
+            QVERIFY(QFile::exists(index_path + ".journal"));
+        }
+
+        HttpMetaCache cache(index_path);
+        cache.addBase("general", dir.path());
+        cache.Load();
+
+        auto entry = cache.getEntry("general", "a/b.json");
+        QVERIFY(entry);
+        QCOMPARE(entry->getMD5Sum(), QString("abc"));
+        QCOMPARE(entry->getETag(), QString("\"abc\""));
+        QCOMPARE(entry->getCurrentAge(), qint64(10));
+        QCOMPARE(entry->getMaximumAge(), qint64(20));
+        QVERIFY(!entry->isEternal());
+
+        entry = cache.getEntry("general", "c.json");
+        QVERIFY(entry);
+        QVERIFY(entry->isEternal());
+    }
+
+    void test_incrementalSave()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+
+            addEntry(cache, "one", "1");
+            addEntry(cache, "two", "2");
+            cache.SaveNow();
+
+            auto size_after_snapshot = QFileInfo(index_path + ".journal").size();
+
+            addEntry(cache, "three", "3");
+            cache.evictEntry(cache.getEntry("general", "one"));
+            cache.SaveNow();
+
+            // only the changes were appended
+            QVERIFY(QFileInfo(index_path + ".journal").size() > size_after_snapshot);
+        }
+
+        HttpMetaCache cache(index_path);
+        cache.addBase("general", dir.path());
+        cache.Load();
+
+        QVERIFY(!cache.getEntry("general", "one"));
+        QVERIFY(cache.getEntry("general", "two"));
+        QCOMPARE(cache.getEntry("general", "three")->getMD5Sum(), QString("3"));
+    }
+
+    void test_tornRecord()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+            addEntry(cache, "one", "1");
+        }
+
+        // pretend we crashed in the middle of appending a record
+        QFile journal(index_path + ".journal");
+        QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+        journal.write(QByteArray::fromHex("000001000102"));
+        journal.close();
+
+        HttpMetaCache cache(index_path);
+        cache.addBase("general", dir.path());
+        cache.Load();
+
+        QVERIFY(cache.getEntry("general", "one"));
+    }
+
+    void test_unknownOp()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+            addEntry(cache, "one", "1");
+        }
+
+        // a whole record, laid out like a put, but with an op nothing writes
+        QByteArray payload;
+        QDataStream record(&payload, QIODevice::WriteOnly);
+        record.setVersion(QDataStream::Qt_5_6);
+        record << quint8(7) << QString("general") << QString("two") << QString("2") << QString("\"2\"") << qint64(1234) << QString()
+               << true << qint64(0) << qint64(0) << qint64(-1) << quint64(0);
+
+        QFile journal(index_path + ".journal");
+        QVERIFY(journal.open(QIODevice::WriteOnly | QIODevice::Append));
+        QDataStream out(&journal);
+        out.setVersion(QDataStream::Qt_5_6);
+        out << payload;
+        journal.close();
+
+        HttpMetaCache cache(index_path);
+        cache.addBase("general", dir.path());
+        cache.Load();
+
+        QVERIFY(cache.getEntry("general", "one"));
+        QVERIFY(!cache.getEntry("general", "two"));
+    }
+
+    void test_revalidateChangedFile()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+        auto file_path = FS::PathCombine(dir.path(), "file.bin");
+
+        QByteArray contents(3 * 1024 * 1024, 'x');
+        FS::write(file_path, contents);
+
+        HttpMetaCache cache(index_path);
+        cache.addBase("general", dir.path());
+        cache.Load();
+
+        auto entry = cache.resolveEntry("general", "file.bin");
+        entry->setMD5Sum(QCryptographicHash::hash(contents, QCryptographicHash::Md5).toHex());
+        entry->setLocalChangedTimestamp(QFileInfo(file_path).lastModified().toUTC().toMSecsSinceEpoch());
+        entry->makeEternal(true);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+
+        QVERIFY(!cache.resolveEntry("general", "file.bin")->isStale());
+
+        // same contents, different timestamp: hashed off-thread, and still valid
+        QFile file(file_path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-3600), QFileDevice::FileModificationTime));
+        file.close();
+
+        bool called = false;
+        cache.resolveEntryAsync("general", "file.bin", {}, this, [&called](MetaEntryPtr result) {
+            called = true;
+            QVERIFY(!result->isStale());
+        });
+        QTRY_VERIFY(called);
+
+        // different size: stale
+        FS::write(file_path, contents + "y");
+        QVERIFY(cache.resolveEntry("general", "file.bin")->isStale());
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_load100k()
+    {
+        QTemporaryDir dir;
+        auto index_path = FS::PathCombine(dir.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+            for (int i = 0; i < 100000; i++) {
+                auto hash = QString::number(i, 16).rightJustified(40, '0');
+                addEntry(cache, QString("%1/%2").arg(hash.left(2), hash), hash);
+            }
+        }
+
+        QBENCHMARK
+        {
+            HttpMetaCache cache(index_path);
+            cache.addBase("general", dir.path());
+            cache.Load();
+        }
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
@@ -37,11 +37,20 @@
 #include "NetJob.h"
 #include "Download.h"
 
+#include "Application.h"
+
+NetJob::~NetJob()
+{
+    if (m_scheduler)
+        m_scheduler->unregister(this);
+}
+
 auto NetJob::addNetAction(NetAction::Ptr action) -> bool
 {
     action->m_index_within_job = m_downloads.size();
     m_downloads.append(action);
     part_info pi;
+    pi.host = action->url().host();
     m_parts_progress.append(pi);
 
     partProgress(m_parts_progress.count() - 1, action->getProgress(), action->getTotalProgress());
@@ -54,6 +63,7 @@ auto NetJob::addNetAction(NetAction::Ptr action) -> bool
         connect(action.get(), &NetAction::status, this, &NetJob::status);
     } else {
         m_todo.append(m_parts_progress.size() - 1);
+        m_hosts.insert(pi.host);
     }
 
     return true;
@@ -79,6 +89,9 @@ auto NetJob::canAbort() const -> bool
 
 void NetJob::executeTask()
 {
+    m_scheduler = APPLICATION->netScheduler();
+    connect(m_scheduler.get(), &Net::Scheduler::slotsAvailable, this, &NetJob::startMoreParts, Qt::UniqueConnection);
+
     // hack that delays early failures so they can be caught easier
     QMetaObject::invokeMethod(this, "startMoreParts", Qt::QueuedConnection);
 }
@@ -105,6 +118,8 @@ auto NetJob::abort() -> bool
     m_failed.unite(m_todo.toSet());
 #endif
     m_todo.clear();
+    if (m_scheduler)
+        m_scheduler->idle(this);
 
     // abort active downloads
     auto toKill = m_doing.values();
@@ -122,6 +137,8 @@ void NetJob::partSucceeded(int index)
     auto& slot = m_parts_progress[index];
     partProgress(index, slot.total_progress, slot.total_progress);
 
+    finishPart(index, true);
+
     m_doing.remove(index);
     m_done.insert(index);
     m_downloads[index].get()->disconnect(this);
@@ -131,6 +148,8 @@ void NetJob::partSucceeded(int index)
 
 void NetJob::partFailed(int index)
 {
+    finishPart(index, false);
+
     m_doing.remove(index);
 
     auto& slot = m_parts_progress[index];
@@ -151,6 +170,12 @@ void NetJob::partAborted(int index)
 {
     m_aborted = true;
 
+    auto& slot = m_parts_progress[index];
+    if (slot.holds_slot) {
+        slot.holds_slot = false;
+        m_scheduler->release(this, slot.host);
+    }
+
     m_doing.remove(index);
     m_failed.insert(index);
     m_downloads[index].get()->disconnect(this);
@@ -158,6 +183,17 @@ void NetJob::partAborted(int index)
     startMoreParts();
 }
 
+void NetJob::finishPart(int index, bool ok)
+{
+    auto& slot = m_parts_progress[index];
+    if (!slot.holds_slot)
+        return;
+
+    slot.holds_slot = false;
+    m_scheduler->report(slot.host, ok, slot.current_progress);
+    m_scheduler->release(this, slot.host);
+}
+
 void NetJob::partProgress(int index, qint64 bytesReceived, qint64 bytesTotal)
 {
     auto& slot = m_parts_progress[index];
@@ -205,7 +241,11 @@ void NetJob::startMoreParts()
     // OK. We are actively processing tasks, proceed.
     // Check for final conditions if there's nothing in the queue.
     if (!m_todo.size()) {
+        m_scheduler->idle(this);
         if (!m_doing.size()) {
+            disconnect(m_scheduler.get(), &Net::Scheduler::slotsAvailable, this, &NetJob::startMoreParts);
+            m_scheduler->unregister(this);
+
             if (!m_failed.size()) {
                 emitSucceeded();
             } else if (m_aborted) {
@@ -217,12 +257,36 @@ void NetJob::startMoreParts()
         return;
     }
 
-    // There's work to do, try to start more parts, to a maximum of 6 concurrent ones.
-    while (m_doing.size() < 6) {
-        if (m_todo.size() == 0)
+    // There's work to do, try to start as many parts as the scheduler lets us.
+    // Hosts that are at their limit are skipped, so they don't block parts going to other hosts.
+    QSet<QString> busy_hosts;
+    while (m_todo.size()) {
+        int queue_pos = -1;
+        for (int i = 0; i < m_todo.size(); i++) {
+            auto const& host = m_parts_progress[m_todo[i]].host;
+            if (busy_hosts.contains(host))
+                continue;
+
+            auto grant = m_scheduler->acquire(this, host);
+            if (grant == Net::Scheduler::Grant::Saturated)
+                return;
+            if (grant == Net::Scheduler::Grant::Granted) {
+                queue_pos = i;
+                break;
+            }
+
+            busy_hosts.insert(host);
+            if (busy_hosts.size() >= m_hosts.size())
+                return;
+        }
+        if (queue_pos < 0)
             return;
-        int doThis = m_todo.dequeue();
+
+        int doThis = m_todo.takeAt(queue_pos);
+        if (m_todo.isEmpty())
+            m_scheduler->idle(this);
         m_doing.insert(doThis);
+        m_parts_progress[doThis].holds_slot = true;
 
         auto part = m_downloads[doThis];
 
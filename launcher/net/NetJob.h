@@ -39,6 +39,7 @@
 
 #include <QObject>
 #include "NetAction.h"
+#include "NetScheduler.h"
 #include "tasks/Task.h"
 
 // Those are included so that they are also included by anyone using NetJob
@@ -55,7 +56,7 @@ class NetJob : public Task {
     {
         setObjectName(job_name);
     }
-    virtual ~NetJob() = default;
+    virtual ~NetJob();
 
     void executeTask() override;
 
@@ -82,13 +83,20 @@ class NetJob : public Task {
     void partFailed(int index);
     void partAborted(int index);
 
+   private:
+    void finishPart(int index, bool ok);
+
    private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    Net::Scheduler::Ptr m_scheduler;
 
     struct part_info {
         qint64 current_progress = 0;
         qint64 total_progress = 1;
         int failures = 0;
+        // the host connection slots are requested for
+        QString host;
+        bool holds_slot = false;
     };
 
     QList<NetAction::Ptr> m_downloads;
@@ -97,6 +105,7 @@ class NetJob : public Task {
     QSet<int> m_doing;
     QSet<int> m_done;
     QSet<int> m_failed;
+    QSet<QString> m_hosts;
     qint64 m_current_progress = 0;
     bool m_aborted = false;
 };
@@ -0,0 +1,177 @@
+#include "NetScheduler.h"
+
+#include <QDebug>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace Net {
+
+// Connections to a single host we start with, and the range the adaptive limit can move in.
+static const int s_initial_host_limit = 6;
+static const int s_min_host_limit = 1;
+static const int s_max_host_limit = 16;
+
+// How long a measurement window has to be, at least, before we take a decision from it.
+static const qint64 s_min_window_ms = 500;
+
+Scheduler::Scheduler(int global_limit, QObject* parent) : QObject(parent), m_global_limit(std::max(1, global_limit)) {}
+
+auto Scheduler::hostLimit(const QString& host) const -> int
+{
+    auto it = m_hosts.constFind(host);
+    if (it == m_hosts.constEnd())
+        return s_initial_host_limit;
+    return it->limit;
+}
+
+auto Scheduler::acquire(const QObject* owner, const QString& host) -> Grant
+{
+    // Asking means it has queued work, which makes it count as contending for the budget until it goes idle.
+    m_waiting.insert(owner);
+
+    if (m_active >= m_global_limit)
+        return Grant::Saturated;
+
+    // Fair share of the global budget between everyone that wants a piece of it.
+    int contenders = m_waiting.size();
+    int fair_share = std::max(1, (m_global_limit + contenders - 1) / contenders);
+    auto owner_it = m_owners.constFind(owner);
+    if (owner_it != m_owners.constEnd() && owner_it->active >= fair_share)
+        return Grant::Saturated;
+
+    auto host_it = m_hosts.find(host);
+    if (host_it == m_hosts.end()) {
+        host_it = m_hosts.insert(host, {});
+        host_it->limit = s_initial_host_limit;
+        host_it->window_timer.start();
+    }
+
+    if (host_it->active >= host_it->limit)
+        return Grant::HostBusy;
+
+    auto& owner_state = m_owners[owner];
+    host_it->active++;
+    owner_state.active++;
+    owner_state.hosts[host]++;
+    m_active++;
+
+    return Grant::Granted;
+}
+
+void Scheduler::release(const QObject* owner, const QString& host)
+{
+    auto owner_it = m_owners.find(owner);
+    if (owner_it == m_owners.end())
+        return;
+
+    auto owner_host_it = owner_it->hosts.find(host);
+    if (owner_host_it == owner_it->hosts.end())
+        return;
+
+    if (--(*owner_host_it) == 0)
+        owner_it->hosts.erase(owner_host_it);
+    if (--owner_it->active == 0)
+        m_owners.erase(owner_it);
+
+    auto host_it = m_hosts.find(host);
+    if (host_it != m_hosts.end())
+        host_it->active--;
+    m_active--;
+
+    notifyEventually();
+}
+
+void Scheduler::report(const QString& host, bool ok, qint64 bytes)
+{
+    auto host_it = m_hosts.find(host);
+    if (host_it == m_hosts.end())
+        return;
+
+    auto& state = *host_it;
+    state.window_completed++;
+    if (!ok)
+        state.window_errors++;
+    else if (bytes > 0)
+        state.window_bytes += bytes;
+
+    if (state.window_completed < 2 * state.limit)
+        return;
+
+    auto elapsed = state.window_timer.elapsed();
+    if (elapsed < s_min_window_ms)
+        return;
+
+    double throughput = (state.window_bytes * 1000.) / elapsed;
+    double error_rate = static_cast<double>(state.window_errors) / state.window_completed;
+
+    int old_limit = state.limit;
+    if (error_rate > 0.2) {
+        // The host is struggling with us, back off hard.
+        state.limit = std::max(s_min_host_limit, state.limit / 2);
+    } else if (state.last_throughput <= 0. || throughput > state.last_throughput * 1.05) {
+        // The last change helped (or we don't know yet), try to go a bit further.
+        state.limit = std::min(s_max_host_limit, state.limit + 1);
+    } else if (throughput < state.last_throughput * 0.8) {
+        // More connections just made things worse.
+        state.limit = std::max(s_min_host_limit, state.limit - 1);
+    }
+
+    if (old_limit != state.limit) {
+        qDebug() << "Connection limit for" << host << "changed from" << old_limit << "to" << state.limit << "(throughput:" << qint64(throughput)
+                 << "B/s, error rate:" << error_rate << ")";
+    }
+
+    state.last_throughput = throughput;
+    state.window_completed = 0;
+    state.window_errors = 0;
+    state.window_bytes = 0;
+    state.window_timer.restart();
+
+    if (state.limit > old_limit)
+        notifyEventually();
+}
+
+void Scheduler::idle(const QObject* owner)
+{
+    // Everyone else's fair share just got bigger.
+    if (m_waiting.remove(owner))
+        notifyEventually();
+}
+
+void Scheduler::unregister(const QObject* owner)
+{
+    bool was_waiting = m_waiting.remove(owner);
+    auto owner_it = m_owners.find(owner);
+    if (owner_it == m_owners.end()) {
+        if (was_waiting)
+            notifyEventually();
+        return;
+    }
+
+    for (auto it = owner_it->hosts.cbegin(); it != owner_it->hosts.cend(); it++) {
+        auto host_it = m_hosts.find(it.key());
+        if (host_it != m_hosts.end())
+            host_it->active -= it.value();
+        m_active -= it.value();
+    }
+
+    m_owners.erase(owner_it);
+
+    // Everyone else's fair share just got bigger.
+    notifyEventually();
+}
+
+void Scheduler::notifyEventually()
+{
+    if (m_notify_pending)
+        return;
+
+    m_notify_pending = true;
+    QTimer::singleShot(0, this, [this] {
+        m_notify_pending = false;
+        emit slotsAvailable();
+    });
+}
+
+}  // namespace Net
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "QObjectPtr.h"
+
+namespace Net {
+
+/** Hands out connection slots to running NetJobs.
+ *
+ * Every job shares a single global budget, and every host has its own limit on top of it.
+ * The per-host limit adapts to what we observe: it grows while adding connections increases the
+ * throughput we get from that host, and backs off when the error rate goes up.
+ *
+ * To keep small jobs from waiting behind large ones, a single job can only hold its fair share
+ * of the global budget while other jobs are contending for it.
+ */
+class Scheduler : public QObject {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<Scheduler>;
+
+    enum class Grant {
+        Granted,    // The caller can start a connection to the host
+        HostBusy,   // The host is at its limit, but other hosts may still be available
+        Saturated   // The caller can't start any more connections right now
+    };
+
+    explicit Scheduler(int global_limit = 24, QObject* parent = nullptr);
+    virtual ~Scheduler() = default;
+
+    /** Try to take a connection slot to `host` on behalf of `owner`. */
+    auto acquire(const QObject* owner, const QString& host) -> Grant;
+    /** Give back a slot previously granted to `owner`. */
+    void release(const QObject* owner, const QString& host);
+    /** Record the outcome of a finished transfer, so the host limit can adapt. */
+    void report(const QString& host, bool ok, qint64 bytes);
+    /** `owner` has nothing queued anymore, so it stops counting against the fair share of the others. */
+    void idle(const QObject* owner);
+    /** Forget about `owner`, returning any slots it still holds. */
+    void unregister(const QObject* owner);
+
+    auto globalLimit() const -> int { return m_global_limit; }
+    auto hostLimit(const QString& host) const -> int;
+    auto activeConnections() const -> int { return m_active; }
+
+   signals:
+    /** Some slots were returned. Emitted at most once per event loop iteration. */
+    void slotsAvailable();
+
+   private:
+    void notifyEventually();
+
+   private:
+    struct HostState {
+        int active = 0;
+        int limit = 0;
+
+        // Measurement window for the adaptive limit
+        QElapsedTimer window_timer;
+        int window_completed = 0;
+        int window_errors = 0;
+        qint64 window_bytes = 0;
+        double last_throughput = 0.;
+    };
+
+    struct OwnerState {
+        int active = 0;
+        QHash<QString, int> hosts;
+    };
+
+    int m_global_limit;
+    int m_active = 0;
+
+    QHash<QString, HostState> m_hosts;
+    QHash<const QObject*, OwnerState> m_owners;
+    // Owners with queued work, the ones the budget is shared between
+    QSet<const QObject*> m_waiting;
+
+    bool m_notify_pending = false;
+};
+
+}  // namespace Net
@@ -0,0 +1,91 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "net/NetScheduler.h"
+
+using Grant = Net::Scheduler::Grant;
+
+class NetSchedulerTest : public QObject {
+    Q_OBJECT
+
+    // Takes connections to different hosts for `owner` until it's told no, returns how many it got
+    static int takeAll(Net::Scheduler& scheduler, const QObject* owner, int& next_host)
+    {
+        int granted = 0;
+        while (scheduler.acquire(owner, QString("host%1.example").arg(next_host)) == Grant::Granted) {
+            granted++;
+            next_host++;
+        }
+        return granted;
+    }
+
+   private slots:
+    void test_hostLimit()
+    {
+        Net::Scheduler scheduler(100);
+        QObject owner;
+        auto limit = scheduler.hostLimit("a.example");
+        QVERIFY(limit > 0);
+
+        for (int i = 0; i < limit; i++)
+            QCOMPARE(scheduler.acquire(&owner, "a.example"), Grant::Granted);
+        QCOMPARE(scheduler.acquire(&owner, "a.example"), Grant::HostBusy);
+        // a busy host doesn't hold up the others
+        QCOMPARE(scheduler.acquire(&owner, "b.example"), Grant::Granted);
+
+        scheduler.release(&owner, "a.example");
+        QCOMPARE(scheduler.acquire(&owner, "a.example"), Grant::Granted);
+        QCOMPARE(scheduler.activeConnections(), limit + 1);
+
+        scheduler.unregister(&owner);
+        QCOMPARE(scheduler.activeConnections(), 0);
+    }
+
+    void test_globalLimit()
+    {
+        Net::Scheduler scheduler(4);
+        QObject owner;
+        int host = 0;
+        QCOMPARE(takeAll(scheduler, &owner, host), 4);
+        QCOMPARE(scheduler.acquire(&owner, "other.example"), Grant::Saturated);
+    }
+
+    void test_fairShare()
+    {
+        Net::Scheduler scheduler(12);
+        QObject big;
+        QObject small;
+        int host = 0;
+
+        // alone, a job can have all of it
+        for (int i = 0; i < 3; i++)
+            QCOMPARE(scheduler.acquire(&big, QString("host%1.example").arg(host++)), Grant::Granted);
+
+        // with two of them queueing, each gets half, even if there's more left
+        QCOMPARE(takeAll(scheduler, &small, host), 6);
+        QCOMPARE(scheduler.activeConnections(), 9);
+
+        // a job that has nothing queued anymore doesn't count, even while its parts are still running
+        scheduler.idle(&big);
+        QCOMPARE(takeAll(scheduler, &small, host), 3);
+        QCOMPARE(scheduler.activeConnections(), 12);
+    }
+
+    void test_slotsAvailable()
+    {
+        Net::Scheduler scheduler(1);
+        QSignalSpy spy(&scheduler, &Net::Scheduler::slotsAvailable);
+        QObject first;
+        QObject second;
+
+        QCOMPARE(scheduler.acquire(&first, "a.example"), Grant::Granted);
+        QCOMPARE(scheduler.acquire(&second, "a.example"), Grant::Saturated);
+        scheduler.release(&first, "a.example");
+        QTRY_COMPARE(spy.count(), 1);
+        QCOMPARE(scheduler.acquire(&second, "a.example"), Grant::Granted);
+    }
+};
+
+QTEST_GUILESS_MAIN(NetSchedulerTest)
+
+#include "NetScheduler_test.moc"
@@ -0,0 +1,266 @@
+#include "RemoteZipEntry.h"
+
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QtEndian>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Application.h"
+
+namespace Net {
+
+static const quint32 s_end_of_central_directory_signature = 0x06054b50;
+static const quint32 s_central_directory_header_signature = 0x02014b50;
+static const quint32 s_local_header_signature = 0x04034b50;
+
+static const int s_end_of_central_directory_size = 22;
+static const int s_central_directory_header_size = 46;
+static const int s_local_header_size = 30;
+
+template <typename T>
+static T readLE(const QByteArray& data, qint64 pos)
+{
+    return qFromLittleEndian<T>(reinterpret_cast<const uchar*>(data.constData() + pos));
+}
+
+RemoteZipEntry::RemoteZipEntry(QUrl url, QString entryName, shared_qobject_ptr<QNetworkAccessManager> network)
+    : m_url(std::move(url)), m_entryName(std::move(entryName)), m_network(network)
+{}
+
+auto RemoteZipEntry::findCentralDirectory(const QByteArray& tail, qint64 tailOffset) -> std::optional<CentralDirectory>
+{
+    // the end of central directory record is followed by a comment of up to 64k, so search backwards
+    for (qint64 pos = tail.size() - s_end_of_central_directory_size; pos >= 0; pos--) {
+        if (readLE<quint32>(tail, pos) != s_end_of_central_directory_signature)
+            continue;
+        // the comment must end the archive exactly, or this was just data that looked like a signature
+        if (pos + s_end_of_central_directory_size + readLE<quint16>(tail, pos + 20) != tail.size())
+            continue;
+
+        CentralDirectory result;
+        result.size = readLE<quint32>(tail, pos + 12);
+        result.offset = readLE<quint32>(tail, pos + 16);
+        if (result.offset == 0xFFFFFFFF || result.size == 0xFFFFFFFF) {
+            qDebug() << "Remote zip needs zip64, which isn't supported";
+            return {};
+        }
+        if (result.offset + result.size > tailOffset + pos)
+            return {};
+        return result;
+    }
+    return {};
+}
+
+auto RemoteZipEntry::parseCentralDirectory(const QByteArray& data) -> std::optional<QList<Entry>>
+{
+    QList<Entry> entries;
+    qint64 pos = 0;
+    while (pos + s_central_directory_header_size <= data.size()) {
+        if (readLE<quint32>(data, pos) != s_central_directory_header_signature)
+            return {};
+
+        Entry entry;
+        entry.method = readLE<quint16>(data, pos + 10);
+        entry.crc = readLE<quint32>(data, pos + 16);
+        entry.compressedSize = readLE<quint32>(data, pos + 20);
+        entry.uncompressedSize = readLE<quint32>(data, pos + 24);
+        auto nameLength = readLE<quint16>(data, pos + 28);
+        auto extraLength = readLE<quint16>(data, pos + 30);
+        auto commentLength = readLE<quint16>(data, pos + 32);
+        entry.localHeaderOffset = readLE<quint32>(data, pos + 42);
+
+        if (pos + s_central_directory_header_size + nameLength > data.size())
+            return {};
+        entry.name = QString::fromUtf8(data.constData() + pos + s_central_directory_header_size, nameLength);
+        entries.append(entry);
+
+        pos += s_central_directory_header_size + nameLength + extraLength + commentLength;
+    }
+    if (pos != data.size())
+        return {};
+    return entries;
+}
+
+auto RemoteZipEntry::readLocalEntry(const QByteArray& data, const Entry& entry) -> std::optional<QByteArray>
+{
+    if (data.size() < s_local_header_size || readLE<quint32>(data, 0) != s_local_header_signature)
+        return {};
+
+    if (entry.uncompressedSize > MAX_ENTRY_SIZE || entry.compressedSize > MAX_ENTRY_SIZE) {
+        qDebug() << entry.name << "is too big to read from a remote zip";
+        return {};
+    }
+
+    qint64 start = s_local_header_size + readLE<quint16>(data, 26) + readLE<quint16>(data, 28);
+    if (start + entry.compressedSize > data.size())
+        return {};
+    auto compressed = QByteArray::fromRawData(data.constData() + start, int(entry.compressedSize));
+
+    QByteArray result;
+    if (entry.method == 0) {
+        result = QByteArray(compressed.constData(), compressed.size());
+    } else if (entry.method == Z_DEFLATED) {
+        result.resize(int(entry.uncompressedSize));
+
+        z_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        // raw deflate, zip entries have no zlib header
+        if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+            return {};
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.constData()));
+        strm.avail_in = compressed.size();
+        strm.next_out = reinterpret_cast<Bytef*>(result.data());
+        strm.avail_out = result.size();
+        auto status = inflate(&strm, Z_FINISH);
+        inflateEnd(&strm);
+        if (status != Z_STREAM_END || strm.total_out != uLong(entry.uncompressedSize))
+            return {};
+    } else {
+        qDebug() << "Unsupported compression method" << entry.method << "for" << entry.name;
+        return {};
+    }
+
+    if (crc32(0, reinterpret_cast<const Bytef*>(result.constData()), result.size()) != entry.crc)
+        return {};
+    return result;
+}
+
+void RemoteZipEntry::executeTask()
+{
+    setStatus(tr("Looking for %1 in %2").arg(m_entryName, m_url.fileName()));
+    request(Stage::Tail, "bytes=-" + QByteArray::number(TAIL_SIZE));
+}
+
+bool RemoteZipEntry::abort()
+{
+    if (m_reply)
+        m_reply->abort();
+    return true;
+}
+
+void RemoteZipEntry::request(Stage stage, const QByteArray& range)
+{
+    m_stage = stage;
+
+    QNetworkRequest request(m_url);
+    request.setHeader(QNetworkRequest::UserAgentHeader, APPLICATION->getUserAgent().toUtf8());
+    request.setRawHeader("Range", range);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+
+    auto reply = m_network->get(request);
+    m_reply = reply;
+    connect(reply, &QNetworkReply::metaDataChanged, this, [reply] {
+        // the server is sending us the whole archive, that's not what we're here for
+        auto status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status >= 200 && status < 300 && status != 206)
+            reply->abort();
+    });
+    connect(reply, &QNetworkReply::finished, this, &RemoteZipEntry::replyFinished);
+}
+
+void RemoteZipEntry::replyFinished()
+{
+    auto reply = m_reply;
+    m_reply = nullptr;
+    reply->deleteLater();
+
+    auto status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 200 && status < 300 && status != 206) {
+        emitFailed(tr("The server doesn't support range requests"));
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        emitFailed(reply->errorString());
+        return;
+    }
+
+    auto data = reply->readAll();
+    switch (m_stage) {
+        case Stage::Tail: {
+            // "bytes <first>-<last>/<total>"
+            auto contentRange = reply->rawHeader("Content-Range");
+            bool ok = false;
+            auto offset = contentRange.mid(6, contentRange.indexOf('-') - 6).toLongLong(&ok);
+            auto archiveSize = ok ? contentRange.mid(contentRange.indexOf('/') + 1).toLongLong(&ok) : 0;
+            if (!contentRange.startsWith("bytes ") || !ok) {
+                emitFailed(tr("Unexpected Content-Range: %1").arg(QString::fromLatin1(contentRange)));
+                return;
+            }
+            tailReceived(data, offset, archiveSize);
+            return;
+        }
+        case Stage::CentralDirectory:
+            centralDirectoryReceived(data);
+            return;
+        case Stage::Entry:
+            entryReceived(data);
+            return;
+    }
+}
+
+void RemoteZipEntry::tailReceived(const QByteArray& data, qint64 offset, qint64 archiveSize)
+{
+    if (offset + data.size() != archiveSize) {
+        emitFailed(tr("Got the wrong part of the archive"));
+        return;
+    }
+
+    auto centralDirectory = findCentralDirectory(data, offset);
+    if (!centralDirectory) {
+        emitFailed(tr("Couldn't find the central directory of the archive"));
+        return;
+    }
+    m_centralDirectory = *centralDirectory;
+
+    // small archives: we already have it all
+    if (m_centralDirectory.offset >= offset) {
+        centralDirectoryReceived(data.mid(int(m_centralDirectory.offset - offset), int(m_centralDirectory.size)));
+        return;
+    }
+    request(Stage::CentralDirectory, QString("bytes=%1-%2")
+                                         .arg(m_centralDirectory.offset)
+                                         .arg(m_centralDirectory.offset + m_centralDirectory.size - 1)
+                                         .toLatin1());
+}
+
+void RemoteZipEntry::centralDirectoryReceived(const QByteArray& data)
+{
+    auto entries = parseCentralDirectory(data);
+    if (!entries) {
+        emitFailed(tr("The central directory of the archive is damaged"));
+        return;
+    }
+
+    auto entry = std::find_if(entries->cbegin(), entries->cend(), [this](const Entry& entry) { return entry.name == m_entryName; });
+    if (entry == entries->cend()) {
+        emitFailed(tr("The archive doesn't contain %1").arg(m_entryName));
+        return;
+    }
+    m_entry = *entry;
+    if (m_entry.uncompressedSize > MAX_ENTRY_SIZE || m_entry.compressedSize > MAX_ENTRY_SIZE) {
+        emitFailed(tr("%1 in the archive is too big").arg(m_entryName));
+        return;
+    }
+
+    // we don't know the size of the local extra field yet, so ask for as much as it could be
+    auto last = std::min(m_centralDirectory.offset,
+                         m_entry.localHeaderOffset + s_local_header_size + 2 * 0xFFFF + m_entry.compressedSize) - 1;
+    request(Stage::Entry, QString("bytes=%1-%2").arg(m_entry.localHeaderOffset).arg(last).toLatin1());
+}
+
+void RemoteZipEntry::entryReceived(const QByteArray& data)
+{
+    auto contents = readLocalEntry(data, m_entry);
+    if (!contents) {
+        emitFailed(tr("Couldn't read %1 from the archive").arg(m_entryName));
+        return;
+    }
+    m_contents = *contents;
+    emitSucceeded();
+}
+
+}  // namespace Net
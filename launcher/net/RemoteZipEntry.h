@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QNetworkReply>
+#include <QUrl>
+
+#include <optional>
+
+#include "QObjectPtr.h"
+#include "tasks/Task.h"
+
+class QNetworkAccessManager;
+
+namespace Net {
+
+/**
+ * Reads a single file out of a remote zip archive using HTTP range requests, without downloading the whole archive.
+ *
+ * It asks for the end of the archive to find the central directory, looks the file up there, and then asks
+ * only for the bytes of that file. Fails if the server doesn't do range requests, or if the archive needs zip64.
+ */
+class RemoteZipEntry : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<RemoteZipEntry>;
+
+    struct Entry {
+        QString name;
+        quint16 method = 0;
+        quint32 crc = 0;
+        qint64 compressedSize = 0;
+        qint64 uncompressedSize = 0;
+        qint64 localHeaderOffset = 0;
+    };
+
+    struct CentralDirectory {
+        qint64 offset = 0;
+        qint64 size = 0;
+    };
+
+    RemoteZipEntry(QUrl url, QString entryName, shared_qobject_ptr<QNetworkAccessManager> network);
+    ~RemoteZipEntry() override = default;
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+    /// Uncompressed contents of the entry, once the task succeeded
+    const QByteArray& contents() const { return m_contents; }
+
+   public:
+    /// How many bytes from the end of the archive are enough to find the central directory, comments included
+    static constexpr qint64 TAIL_SIZE = 22 + 0xFFFF;
+    /// The biggest entry we read, anything this is used for is much smaller. Protects us from archives that lie about it.
+    static constexpr qint64 MAX_ENTRY_SIZE = 64 * 1024 * 1024;
+
+    /// Find the central directory in the last bytes of the archive. `tailOffset` is where in the archive `tail` starts.
+    static std::optional<CentralDirectory> findCentralDirectory(const QByteArray& tail, qint64 tailOffset);
+    static std::optional<QList<Entry>> parseCentralDirectory(const QByteArray& data);
+    /// Uncompress the entry from `data`, which starts at its local header
+    static std::optional<QByteArray> readLocalEntry(const QByteArray& data, const Entry& entry);
+
+   protected:
+    void executeTask() override;
+
+   private slots:
+    void replyFinished();
+
+   private:
+    enum class Stage { Tail, CentralDirectory, Entry };
+
+    void request(Stage stage, const QByteArray& range);
+    void tailReceived(const QByteArray& data, qint64 offset, qint64 archiveSize);
+    void centralDirectoryReceived(const QByteArray& data);
+    void entryReceived(const QByteArray& data);
+
+   private:
+    QUrl m_url;
+    QString m_entryName;
+    shared_qobject_ptr<QNetworkAccessManager> m_network;
+
+    Stage m_stage = Stage::Tail;
+    QNetworkReply* m_reply = nullptr;
+    CentralDirectory m_centralDirectory;
+    Entry m_entry;
+    QByteArray m_contents;
+};
+
+}  // namespace Net
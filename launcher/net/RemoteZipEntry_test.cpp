@@ -0,0 +1,118 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+
+#include "FileSystem.h"
+#include "net/RemoteZipEntry.h"
+
+using Net::RemoteZipEntry;
+
+class RemoteZipEntryTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray makeZip(const QString& path, const QString& comment)
+    {
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdCreate))
+            return {};
+        QuaZipFile file(&zip);
+
+        // something big in front, like overrides, so the directory isn't within reach of a small tail
+        file.open(QIODevice::WriteOnly, QuaZipNewInfo("overrides/big.bin"), nullptr, 0, 0, 0);
+        file.write(QByteArray(256 * 1024, 'x'));
+        file.close();
+
+        file.open(QIODevice::WriteOnly, QuaZipNewInfo("modrinth.index.json"));
+        file.write(QByteArray("{\"formatVersion\": 1}").repeated(100));
+        file.close();
+
+        file.open(QIODevice::WriteOnly, QuaZipNewInfo("stored.txt"), nullptr, 0, 0, 0);
+        file.write("not compressed");
+        file.close();
+
+        zip.setComment(comment);
+        zip.close();
+        return FS::read(path);
+    }
+
+    static std::optional<QByteArray> readEntry(const QByteArray& archive, qint64 tailSize, const QString& name)
+    {
+        auto tailOffset = std::max<qint64>(0, archive.size() - tailSize);
+        auto directory = RemoteZipEntry::findCentralDirectory(archive.mid(int(tailOffset)), tailOffset);
+        if (!directory)
+            return {};
+
+        auto entries = RemoteZipEntry::parseCentralDirectory(archive.mid(int(directory->offset), int(directory->size)));
+        if (!entries)
+            return {};
+
+        for (auto& entry : *entries) {
+            if (entry.name == name)
+                return RemoteZipEntry::readLocalEntry(archive.mid(int(entry.localHeaderOffset)), entry);
+        }
+        return {};
+    }
+
+   private slots:
+    void test_read_data()
+    {
+        QTest::addColumn<QString>("comment");
+        QTest::addColumn<qint64>("tailSize");
+
+        QTest::newRow("whole file") << QString() << qint64(1024 * 1024);
+        QTest::newRow("tail") << QString() << RemoteZipEntry::TAIL_SIZE;
+        QTest::newRow("tail with comment") << QString("PK\x05\x06 pretending to be a signature") << RemoteZipEntry::TAIL_SIZE;
+    }
+    void test_read()
+    {
+        QFETCH(QString, comment);
+        QFETCH(qint64, tailSize);
+
+        QTemporaryDir dir;
+        auto archive = makeZip(FS::PathCombine(dir.path(), "pack.mrpack"), comment);
+        QVERIFY(!archive.isEmpty());
+
+        auto index = readEntry(archive, tailSize, "modrinth.index.json");
+        QVERIFY(index);
+        QCOMPARE(*index, QByteArray("{\"formatVersion\": 1}").repeated(100));
+
+        auto stored = readEntry(archive, tailSize, "stored.txt");
+        QVERIFY(stored);
+        QCOMPARE(*stored, QByteArray("not compressed"));
+
+        QVERIFY(!readEntry(archive, tailSize, "missing.json"));
+    }
+
+    void test_damaged()
+    {
+        QTemporaryDir dir;
+        auto archive = makeZip(FS::PathCombine(dir.path(), "pack.mrpack"), {});
+
+        // not the end of the archive
+        QVERIFY(!RemoteZipEntry::findCentralDirectory(archive.left(archive.size() - 10), 0));
+
+        // flipped bits in the compressed data are caught by the CRC
+        auto directory = RemoteZipEntry::findCentralDirectory(archive, 0);
+        QVERIFY(directory);
+        auto entries = RemoteZipEntry::parseCentralDirectory(archive.mid(int(directory->offset), int(directory->size)));
+        QVERIFY(entries);
+        auto entry = entries->at(2);
+        QCOMPARE(entry.name, QString("stored.txt"));
+        auto data = archive.mid(int(entry.localHeaderOffset));
+        data[data.indexOf("not compressed")] = 'N';
+        QVERIFY(!RemoteZipEntry::readLocalEntry(data, entry));
+
+        // a size nobody needs is refused before anything is allocated for it
+        auto deflated = entries->at(1);
+        QCOMPARE(deflated.name, QString("modrinth.index.json"));
+        QVERIFY(RemoteZipEntry::readLocalEntry(archive.mid(int(deflated.localHeaderOffset)), deflated));
+        deflated.uncompressedSize = 0xFFFFFFFF;
+        QVERIFY(!RemoteZipEntry::readLocalEntry(archive.mid(int(deflated.localHeaderOffset)), deflated));
+    }
+};
+
+QTEST_GUILESS_MAIN(RemoteZipEntryTest)
+
+#include "RemoteZipEntry_test.moc"
@@ -97,10 +97,10 @@ QString INIFile::escape(QString orig)
     return out;
 }
 
-bool INIFile::saveFile(QString fileName)
+QByteArray INIFile::toByteArray() const
 {
     QByteArray outArray;
-    for (Iterator iter = begin(); iter != end(); iter++)
+    for (ConstIterator iter = begin(); iter != end(); iter++)
     {
         QString value = iter.value().toString();
         value = escape(value);
@@ -109,10 +109,14 @@ bool INIFile::saveFile(QString fileName)
         outArray.append(value.toUtf8());
         outArray.append('\n');
     }
+    return outArray;
+}
 
+bool INIFile::saveFile(QString fileName)
+{
     try
     {
-        FS::write(fileName, outArray);
+        FS::write(fileName, toByteArray());
     }
     catch (const Exception &e)
     {
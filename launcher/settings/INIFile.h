@@ -28,6 +28,8 @@ public:
     bool loadFile(QByteArray file);
     bool loadFile(QString fileName);
     bool saveFile(QString fileName);
+    /// What saveFile() writes
+    QByteArray toByteArray() const;
 
     QVariant get(QString key, QVariant def) const;
     void set(QString key, QVariant val);
@@ -15,14 +15,23 @@
 
 #include "INISettingsObject.h"
 #include "Setting.h"
+#include "WriteBehindQueue.h"
 
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
     : SettingsObject(parent)
 {
     m_filePath = path;
+    // changes to it might still be on their way to the disk
+    WriteBehindQueue::instance().flush(path);
     m_ini.loadFile(path);
 }
 
+INISettingsObject::~INISettingsObject()
+{
+    // whoever looks at the file next should see all of our changes
+    WriteBehindQueue::instance().flush(m_filePath);
+}
+
 void INISettingsObject::setFilePath(const QString &filePath)
 {
     m_filePath = filePath;
@@ -30,6 +39,7 @@ void INISettingsObject::setFilePath(const QString &filePath)
 
 bool INISettingsObject::reload()
 {
+    WriteBehindQueue::instance().flush(m_filePath);
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
@@ -43,7 +53,8 @@ void INISettingsObject::resumeSave()
     m_suspendSave = false;
     if(m_doSave)
     {
-        m_ini.saveFile(m_filePath);
+        m_doSave = false;
+        doSave();
     }
 }
 
@@ -77,7 +88,7 @@ void INISettingsObject::doSave()
     }
     else
     {
-        m_ini.saveFile(m_filePath);
+        WriteBehindQueue::instance().write(m_filePath, m_ini.toByteArray());
     }
 }
 
@@ -29,6 +29,7 @@ class INISettingsObject : public SettingsObject
     Q_OBJECT
 public:
     explicit INISettingsObject(const QString &path, QObject *parent = 0);
+    virtual ~INISettingsObject();
 
     /*!
      * \brief Gets the path to the INI file.
@@ -56,6 +57,7 @@ protected slots:
 
 protected:
     virtual QVariant retrieveValue(const Setting &setting) override;
+    // queue the file to be written, see WriteBehindQueue
     void doSave();
 
 protected:
@@ -0,0 +1,147 @@
+#include "WriteBehindQueue.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "Exception.h"
+#include "FileSystem.h"
+
+static QString absolutePath(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+WriteBehindQueue& WriteBehindQueue::instance()
+{
+    static WriteBehindQueue queue;
+    return queue;
+}
+
+WriteBehindQueue::WriteBehindQueue(int delay_ms) : m_delay(delay_ms)
+{
+    m_clock.start();
+    m_thread.reset(QThread::create([this] { run(); }));
+    m_thread->start();
+}
+
+WriteBehindQueue::~WriteBehindQueue()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_changed.wakeAll();
+    }
+    m_thread->wait();
+}
+
+void WriteBehindQueue::write(const QString& path, const QByteArray& contents)
+{
+    QMutexLocker locker(&m_mutex);
+    if (isIgnored(path))
+        return;
+    auto iter = m_pending.find(path);
+    if (iter != m_pending.end()) {
+        // it's going out when the first change would have, with the latest contents
+        iter->contents = contents;
+        return;
+    }
+    m_pending.insert(path, { contents, m_clock.elapsed() });
+    m_changed.wakeAll();
+}
+
+void WriteBehindQueue::flush(const QString& path)
+{
+    QMutexLocker locker(&m_mutex);
+    auto done = [&] {
+        if (path.isEmpty())
+            return m_pending.isEmpty() && m_writing.isEmpty();
+        return !m_pending.contains(path) && m_writing != path;
+    };
+    if (done())
+        return;
+
+    m_flushing++;
+    m_changed.wakeAll();
+    while (!done())
+        m_written.wait(&m_mutex);
+    m_flushing--;
+}
+
+void WriteBehindQueue::ignoreDirectory(const QString& dir)
+{
+    QMutexLocker locker(&m_mutex);
+    auto absolute = absolutePath(dir);
+    if (!m_ignored.contains(absolute))
+        m_ignored.append(absolute);
+    for (auto iter = m_pending.begin(); iter != m_pending.end();) {
+        if (isIgnored(iter.key()))
+            iter = m_pending.erase(iter);
+        else
+            ++iter;
+    }
+    // those waiting for a flush may be waiting for one of them
+    m_written.wakeAll();
+    // and one that is being written right now has to be done before the folder goes
+    while (!m_writing.isEmpty() && isIgnored(m_writing))
+        m_written.wait(&m_mutex);
+}
+
+void WriteBehindQueue::stopIgnoringDirectory(const QString& dir)
+{
+    QMutexLocker locker(&m_mutex);
+    m_ignored.removeAll(absolutePath(dir));
+}
+
+bool WriteBehindQueue::isIgnored(const QString& path) const
+{
+    if (m_ignored.isEmpty())
+        return false;
+    auto absolute = absolutePath(path);
+    for (auto& dir : m_ignored) {
+        if (absolute.startsWith(dir + '/'))
+            return true;
+    }
+    return false;
+}
+
+void WriteBehindQueue::run()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        if (m_pending.isEmpty()) {
+            if (m_quit)
+                return;
+            m_changed.wait(&m_mutex);
+            continue;
+        }
+
+        // the one that has been waiting the longest
+        auto next = m_pending.begin();
+        for (auto iter = m_pending.begin(); iter != m_pending.end(); ++iter) {
+            if (iter->queuedAt < next->queuedAt)
+                next = iter;
+        }
+        qint64 wait = next->queuedAt + m_delay - m_clock.elapsed();
+        if (wait > 0 && !m_quit && m_flushing == 0) {
+            m_changed.wait(&m_mutex, static_cast<unsigned long>(wait));
+            continue;
+        }
+
+        auto path = next.key();
+        auto contents = next->contents;
+        m_pending.erase(next);
+        m_writing = path;
+
+        locker.unlock();
+        try {
+            FS::write(path, contents);
+        } catch (const Exception& e) {
+            qCritical() << e.what();
+        }
+        locker.relock();
+
+        m_writing.clear();
+        m_written.wakeAll();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+
+/**
+ * Writes settings files from a thread of its own, a little while after they change.
+ *
+ * Each file has at most one write waiting: queueing new contents for it replaces what was still waiting, so a burst of
+ * changes to the same file ends up as a single write. Files are written with FS::write, which replaces them atomically,
+ * so a crash leaves either the old or the new file, never half of one.
+ *
+ * Anything that reads a settings file from disk has to flush() it first. Everything left is written when the queue
+ * goes away.
+ */
+class WriteBehindQueue
+{
+public:
+    /// The queue all settings files go through
+    static WriteBehindQueue& instance();
+
+    /// Files are written `delay_ms` after they first changed
+    explicit WriteBehindQueue(int delay_ms = 1000);
+    ~WriteBehindQueue();
+
+    /// Write `contents` to `path` in a little while
+    void write(const QString& path, const QByteArray& contents);
+
+    /// Write what is waiting for `path` right away, or everything if there's no `path`, and wait until it's done
+    void flush(const QString& path = QString());
+
+    /// Drop what is waiting for files in `dir` and ignore any writes to them from now on, for folders that are gone
+    void ignoreDirectory(const QString& dir);
+    /// Write files in `dir` again, once there is a folder there again
+    void stopIgnoringDirectory(const QString& dir);
+
+private:
+    void run();
+    // whether `path` is in one of the ignored folders, with m_mutex held
+    bool isIgnored(const QString& path) const;
+
+private:
+    struct Pending
+    {
+        QByteArray contents;
+        // when it was first queued, on m_clock
+        qint64 queuedAt;
+    };
+
+    const int m_delay;
+    QElapsedTimer m_clock;
+
+    QMutex m_mutex;
+    // wakes up the writer thread
+    QWaitCondition m_changed;
+    // wakes up those waiting for a flush
+    QWaitCondition m_written;
+
+    QHash<QString, Pending> m_pending;
+    // the file being written right now
+    QString m_writing;
+    // how many are waiting for a flush, the delay doesn't matter while there are any
+    int m_flushing = 0;
+    bool m_quit = false;
+    // absolute paths of folders we don't write to
+    QStringList m_ignored;
+
+    std::unique_ptr<QThread> m_thread;
+};
@@ -0,0 +1,152 @@
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "FileSystem.h"
+#include "settings/INIFile.h"
+#include "settings/INISettingsObject.h"
+#include "settings/WriteBehindQueue.h"
+
+class WriteBehindQueueTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray contentsOf(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QFile::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+   private slots:
+    void test_coalesce()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.cfg");
+        WriteBehindQueue queue(60 * 1000);
+
+        for (int i = 0; i < 100; i++)
+            queue.write(path, QByteArray::number(i));
+        // nothing yet, it's waiting for more
+        QVERIFY(!QFile::exists(path));
+
+        queue.flush(path);
+        QCOMPARE(contentsOf(path), QByteArray("99"));
+
+        queue.write(path, "again");
+        queue.flush();
+        QCOMPARE(contentsOf(path), QByteArray("again"));
+    }
+
+    void test_delay()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.cfg");
+        WriteBehindQueue queue(50);
+
+        queue.write(path, "first");
+        QTRY_COMPARE(contentsOf(path), QByteArray("first"));
+        queue.write(path, "second");
+        QTRY_COMPARE(contentsOf(path), QByteArray("second"));
+    }
+
+    void test_destroy()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "test.cfg");
+        {
+            WriteBehindQueue queue(60 * 1000);
+            queue.write(path, "last words");
+        }
+        QCOMPARE(contentsOf(path), QByteArray("last words"));
+    }
+
+    void test_ignoreDirectory()
+    {
+        QTemporaryDir dir;
+        auto instance = FS::PathCombine(dir.path(), "instance");
+        auto path = FS::PathCombine(instance, "instance.cfg");
+        auto other = FS::PathCombine(dir.path(), "instances.cfg");
+        WriteBehindQueue queue(60 * 1000);
+
+        // the instance goes away with a write still waiting, and another one comes after
+        queue.write(path, "pending");
+        queue.write(other, "kept");
+        queue.ignoreDirectory(instance);
+        queue.write(path, "late");
+        queue.flush();
+        QVERIFY(!QDir(instance).exists());
+        QCOMPARE(contentsOf(other), QByteArray("kept"));
+
+        // a new one by the same name
+        queue.stopIgnoringDirectory(instance);
+        queue.write(path, "new");
+        queue.flush();
+        QCOMPARE(contentsOf(path), QByteArray("new"));
+    }
+
+    void test_settings()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "instance.cfg");
+        {
+            INISettingsObject settings(path);
+            settings.registerSetting("name", "default");
+            settings.registerSetting("playtime", 0);
+            settings.set("name", "changed");
+            for (int i = 1; i <= 100; i++)
+                settings.set("playtime", i);
+
+            // another look at the same file sees the latest changes
+            INISettingsObject other(path);
+            other.registerSetting("name", "default");
+            other.registerSetting("playtime", 0);
+            QCOMPARE(other.get("name").toString(), QString("changed"));
+            QCOMPARE(other.get("playtime").toInt(), 100);
+
+            settings.set("name", "changed again");
+        }
+        // and so does anything reading it after the settings are gone
+        INIFile ini;
+        QVERIFY(ini.loadFile(path));
+        QCOMPARE(ini.get("name", "").toString(), QString("changed again"));
+    }
+
+#ifdef LAUNCHER_BENCHMARKS
+    void benchmark_changes_data()
+    {
+        QTest::addColumn<bool>("writeBehind");
+
+        QTest::newRow("write every change") << false;
+        QTest::newRow("write behind") << true;
+    }
+    void benchmark_changes()
+    {
+        QFETCH(bool, writeBehind);
+
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "instance.cfg");
+        INIFile ini;
+        for (int i = 0; i < 60; i++)
+            ini.set(QString("Setting%1").arg(i), QString("some value %1").arg(i));
+
+        // like the play time of a running instance being updated, or a bulk edit
+        const int changes = 200;
+        QBENCHMARK
+        {
+            for (int i = 0; i < changes; i++) {
+                ini.set("TotalTimePlayed", i);
+                if (writeBehind)
+                    WriteBehindQueue::instance().write(path, ini.toByteArray());
+                else
+                    ini.saveFile(path);
+            }
+        }
+        WriteBehindQueue::instance().flush();
+    }
+#endif
+};
+
+QTEST_GUILESS_MAIN(WriteBehindQueueTest)
+
+#include "WriteBehindQueue_test.moc"
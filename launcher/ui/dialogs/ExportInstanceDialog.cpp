@@ -47,9 +47,11 @@
 #include <QSaveFile>
 #include "MMCStrings.h"
 #include "SeparatorPrefixTree.h"
+#include "pathmatcher/RegexpMatcher.h"
 #include "Application.h"
 #include <icons/IconList.h>
 #include <FileSystem.h>
+#include "settings/WriteBehindQueue.h"
 
 class PackIgnoreProxy : public QSortFilterProxyModel
 {
@@ -420,12 +422,15 @@ bool ExportInstanceDialog::doExport()
     }
 
     SaveIcon(m_instance);
+    // the settings that are about to go in the zip might not be written yet
+    WriteBehindQueue::instance().flush();
 
     auto & blocked = proxyModel->blockedPaths();
-    using std::placeholders::_1;
+    // the modded jar is built again on launch, so it doesn't go in the zip
+    RegexpMatcher moddedJar("^[.]?minecraft/bin/minecraft[.]jar([.]key|[.]tmp)?$");
     auto files = QFileInfoList();
-    if (!MMCZip::collectFileListRecursively(m_instance->instanceRoot(), nullptr, &files,
-                                    std::bind(&SeparatorPrefixTree<'/'>::covers, blocked, _1))) {
+    auto excluded = [&blocked, &moddedJar](const QString &path) { return blocked.covers(path) || moddedJar.matches(path); };
+    if (!MMCZip::collectFileListRecursively(m_instance->instanceRoot(), nullptr, &files, excluded)) {
         QMessageBox::warning(this, tr("Error"), tr("Unable to export instance"));
         return false;
     }
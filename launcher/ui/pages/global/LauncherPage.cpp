@@ -340,7 +340,6 @@ void LauncherPage::applySettings()
     s->set("ConsoleFont", consoleFontFamily);
     s->set("ConsoleFontSize", ui->fontSizeBox->value());
     s->set("ConsoleMaxLines", ui->lineLimitSpinBox->value());
-    s->set("ConsoleOverflowStop", ui->checkStopLogging->checkState() != Qt::Unchecked);
 
     // Folders
     // TODO: Offer to move instances to new instance folder.
@@ -456,7 +455,6 @@ void LauncherPage::loadSettings()
     ui->fontSizeBox->setValue(fontSize);
     refreshFontPreview();
     ui->lineLimitSpinBox->setValue(s->get("ConsoleMaxLines").toInt());
-    ui->checkStopLogging->setChecked(s->get("ConsoleOverflowStop").toBool());
 
     // Folders
     ui->instDirTextBox->setText(s->get("InstanceDir").toString());
@@ -342,17 +342,32 @@ void LogPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    ui->text->findNext(ui->searchBar->text(), reverse);
+    findNext(ui->searchBar->text(), reverse);
 }
 
 void LogPage::findNextActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), false);
+    findNext(ui->searchBar->text(), false);
 }
 
 void LogPage::findPreviousActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), true);
+    findNext(ui->searchBar->text(), true);
+}
+
+void LogPage::findNext(const QString& what, bool reverse)
+{
+    if(!m_model)
+    {
+        ui->text->findNext(what, reverse);
+        return;
+    }
+    // search the whole log, not just what the view has loaded
+    int row = m_model->find(what, ui->text->currentRow() + (reverse ? -1 : 1), reverse);
+    if(row >= 0)
+    {
+        ui->text->showRow(row, what);
+    }
 }
 
 void LogPage::findActivated()
@@ -96,6 +96,7 @@ private:
     void modelStateToUI();
     void UIToModelState();
     void setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial);
+    void findNext(const QString& what, bool reverse);
 
 private:
     Ui::LogPage *ui;
@@ -41,17 +41,39 @@
 #include "ui/GuiUtil.h"
 
 #include "RecursiveFileSystemWatcher.h"
-#include <GZip.h>
+#include "launch/LogFileModel.h"
 #include <FileSystem.h>
 #include <QShortcut>
 
+#include <algorithm>
+
+// files bigger than this are only shown, not copied or uploaded as a whole
+static const qint64 s_max_whole_size = 1024ll * 1024ll * 12ll;
+
 OtherLogsPage::OtherLogsPage(QString path, IPathMatcher::Ptr fileFilter, QWidget *parent)
     : QWidget(parent), ui(new Ui::OtherLogsPage), m_path(path), m_fileFilter(fileFilter),
-      m_watcher(new RecursiveFileSystemWatcher(this))
+      m_watcher(new RecursiveFileSystemWatcher(this)), m_model(new LogFileModel(this))
 {
     ui->setupUi(this);
     ui->tabWidget->tabBar()->hide();
 
+    {
+        QString fontFamily = APPLICATION->settings()->get("ConsoleFont").toString();
+        bool conversionOk = false;
+        int fontSize = APPLICATION->settings()->get("ConsoleFontSize").toInt(&conversionOk);
+        if(!conversionOk)
+        {
+            fontSize = 11;
+        }
+        ui->text->document()->setDefaultFont(QFont(fontFamily, fontSize));
+    }
+    // it's a file, so it starts at the top and stays there while the rest of it comes in
+    ui->text->setFollowing(false);
+    ui->text->setModel(m_model);
+    ui->indexProgress->hide();
+    connect(m_model, &LogFileModel::indexingProgress, this, &OtherLogsPage::indexingProgress);
+    connect(m_model, &LogFileModel::indexingFinished, this, &OtherLogsPage::indexingFinished);
+
     m_watcher->setMatcher(fileFilter);
     m_watcher->setRootDir(QDir::current().absoluteFilePath(m_path));
 
@@ -124,7 +146,7 @@ void OtherLogsPage::on_selectLogBox_currentIndexChanged(const int index)
     if (file.isEmpty() || !QFile::exists(FS::PathCombine(m_path, file)))
     {
         m_currentFile = QString();
-        ui->text->clear();
+        m_model->close();
         setControlsEnabled(false);
     }
     else
@@ -142,74 +164,70 @@ void OtherLogsPage::on_btnReload_clicked()
         setControlsEnabled(false);
         return;
     }
-    QFile file(FS::PathCombine(m_path, m_currentFile));
-    if (!file.open(QFile::ReadOnly))
+    // only the lines on screen are read from the file, so there is no limit on how big it can be
+    if (!m_model->open(FS::PathCombine(m_path, m_currentFile)))
+    {
+        indexingFinished(false);
+    }
+    else
+    {
+        ui->indexProgress->setValue(0);
+        ui->indexProgress->show();
+        ui->text->scrollToTop();
+    }
+}
+
+void OtherLogsPage::indexingProgress(qint64 done, qint64 total)
+{
+    // a log that is still being written can grow past what it was when we started
+    ui->indexProgress->setValue(total > 0 ? int(std::min<qint64>(done, total) * 100 / total) : 0);
+}
+
+void OtherLogsPage::indexingFinished(bool ok)
+{
+    ui->indexProgress->hide();
+    if (!ok)
     {
         setControlsEnabled(false);
         ui->btnReload->setEnabled(true); // allow reload
-        m_currentFile = QString();
         QMessageBox::critical(this, tr("Error"), tr("Unable to open %1 for reading: %2")
-                                                     .arg(m_currentFile, file.errorString()));
+                                                     .arg(m_currentFile, m_model->errorString()));
+        m_currentFile = QString();
+        return;
     }
-    else
+    // the whole of it is known now
+    setControlsEnabled(true);
+}
+
+bool OtherLogsPage::wholeText(QString& text)
+{
+    if(m_model->size() > s_max_whole_size)
     {
-        auto setPlainText = [&](const QString & text)
-        {
-            QString fontFamily = APPLICATION->settings()->get("ConsoleFont").toString();
-            bool conversionOk = false;
-            int fontSize = APPLICATION->settings()->get("ConsoleFontSize").toInt(&conversionOk);
-            if(!conversionOk)
-            {
-                fontSize = 11;
-            }
-            QTextDocument *doc = ui->text->document();
-            doc->setDefaultFont(QFont(fontFamily, fontSize));
-            ui->text->setPlainText(text);
-        };
-        auto showTooBig = [&]()
-        {
-            setPlainText(
-                tr("The file (%1) is too big. You may want to open it in a viewer optimized "
-                   "for large files.").arg(file.fileName()));
-        };
-        if(file.size() > (1024ll * 1024ll * 12ll))
-        {
-            showTooBig();
-            return;
-        }
-        QString content;
-        if(file.fileName().endsWith(".gz"))
-        {
-            QByteArray temp;
-            if(!GZip::unzip(file.readAll(), temp))
-            {
-                setPlainText(
-                    tr("The file (%1) is not readable.").arg(file.fileName()));
-                return;
-            }
-            content = QString::fromUtf8(temp);
-        }
-        else
-        {
-            content = QString::fromUtf8(file.readAll());
-        }
-        if (content.size() >= 50000000ll)
-        {
-            showTooBig();
-            return;
-        }
-        setPlainText(content);
+        QMessageBox::warning(this, tr("Error"),
+            tr("The file (%1) is too big. You may want to open it in a viewer optimized "
+               "for large files.").arg(m_currentFile));
+        return false;
     }
+    text = QString::fromUtf8(m_model->readAll());
+    return true;
 }
 
 void OtherLogsPage::on_btnPaste_clicked()
 {
-    GuiUtil::uploadPaste(ui->text->toPlainText(), this);
+    QString text;
+    if(wholeText(text))
+    {
+        GuiUtil::uploadPaste(text, this);
+    }
 }
 
 void OtherLogsPage::on_btnCopy_clicked()
 {
-    GuiUtil::setClipboardText(ui->text->toPlainText());
+    QString text;
+    if(wholeText(text))
+    {
+        GuiUtil::setClipboardText(text);
+    }
 }
 
 void OtherLogsPage::on_btnDelete_clicked()
@@ -225,11 +243,14 @@ void OtherLogsPage::on_btnDelete_clicked()
     {
         return;
     }
+    // stop indexing it, that has it open
+    m_model->close();
     QFile file(FS::PathCombine(m_path, m_currentFile));
     if (!file.remove())
     {
         QMessageBox::critical(this, tr("Error"), tr("Unable to delete %1: %2")
                                                      .arg(m_currentFile, file.errorString()));
+        on_btnReload_clicked();
     }
 }
 
@@ -263,6 +284,7 @@ void OtherLogsPage::on_btnClean_clicked()
     {
         return;
     }
+    m_model->close();
     QStringList failed;
     for(auto item: toDelete)
     {
@@ -274,6 +296,10 @@ void OtherLogsPage::on_btnClean_clicked()
     }
     if(!failed.empty())
     {
+        if(failed.contains(m_currentFile))
+        {
+            on_btnReload_clicked();
+        }
         QMessageBox *messageBox = new QMessageBox(this);
         messageBox->setWindowTitle(tr("Error"));
         if(failed.size() > 5)
@@ -299,33 +325,47 @@ void OtherLogsPage::setControlsEnabled(const bool enabled)
 {
     ui->btnReload->setEnabled(enabled);
     ui->btnDelete->setEnabled(enabled);
-    ui->btnCopy->setEnabled(enabled);
-    ui->btnPaste->setEnabled(enabled);
+    // those need all of it
+    ui->btnCopy->setEnabled(enabled && !m_model->isIndexing());
+    ui->btnPaste->setEnabled(enabled && !m_model->isIndexing());
     ui->text->setEnabled(enabled);
     ui->btnClean->setEnabled(enabled);
 }
 
-// FIXME: HACK, use LogView instead?
-static void findNext(QPlainTextEdit * _this, const QString& what, bool reverse)
+void OtherLogsPage::findNext(const QString& what, bool reverse)
 {
-    _this->find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
+    int row = m_model->find(what, ui->text->currentRow() + (reverse ? -1 : 1), reverse);
+    if(row >= 0)
+    {
+        ui->text->showRow(row, what);
+    }
 }
 
 void OtherLogsPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    findNext(ui->text, ui->searchBar->text(), reverse);
+    findNext(ui->searchBar->text(), reverse);
 }
 
 void OtherLogsPage::findNextActivated()
 {
-    findNext(ui->text, ui->searchBar->text(), false);
+    findNext(ui->searchBar->text(), false);
 }
 
 void OtherLogsPage::findPreviousActivated()
 {
-    findNext(ui->text, ui->searchBar->text(), true);
+    findNext(ui->searchBar->text(), true);
+}
+
+void OtherLogsPage::on_searchBar_textEdited(const QString& text)
+{
+    // search as you type, staying on the current line while it still matches
+    int row = m_model->find(text, ui->text->currentRow(), false);
+    if(row >= 0)
+    {
+        ui->text->showRow(row, text);
+    }
 }
 
 void OtherLogsPage::findActivated()
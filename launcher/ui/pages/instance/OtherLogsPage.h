@@ -47,6 +47,7 @@ class OtherLogsPage;
 }
 
 class RecursiveFileSystemWatcher;
+class LogFileModel;
 
 class OtherLogsPage : public QWidget, public BasePage
 {
@@ -90,9 +91,16 @@ private slots:
     void findActivated();
     void findNextActivated();
     void findPreviousActivated();
+    void on_searchBar_textEdited(const QString& text);
+
+    void indexingProgress(qint64 done, qint64 total);
+    void indexingFinished(bool ok);
 
 private:
     void setControlsEnabled(const bool enabled);
+    void findNext(const QString& what, bool reverse);
+    // the whole file, unless it's too big for that
+    bool wholeText(QString& text);
 
 private:
     Ui::OtherLogsPage *ui;
@@ -100,4 +108,5 @@ private:
     QString m_currentFile;
     IPathMatcher::Ptr m_fileFilter;
     RecursiveFileSystemWatcher *m_watcher;
+    LogFileModel *m_model;
 };
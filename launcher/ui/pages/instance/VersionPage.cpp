@@ -57,6 +57,7 @@
 
 #include "ui/GuiUtil.h"
 
+#include "minecraft/AssetsLedger.h"
 #include "minecraft/PackProfile.h"
 #include "minecraft/auth/AccountList.h"
 #include "minecraft/mod/Mod.h"
@@ -432,6 +433,9 @@ void VersionPage::on_actionDownload_All_triggered()
         return;
     }
 
+    // the user asked for it, so look at every asset object on disk again
+    AssetsLedger::invalidate("assets/objects");
+
     auto updateTask = m_inst->createUpdateTask(Net::Mode::Online);
     if (!updateTask)
     {
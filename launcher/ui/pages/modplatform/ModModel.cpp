@@ -136,9 +136,9 @@ void ListModel::searchWithTerm(const QString& term, const int sort, const bool f
 void ListModel::getLogo(const QString& logo, const QString& logoUrl, LogoCallback callback)
 {
     if (m_logoMap.contains(logo)) {
-        callback(APPLICATION->metacache()
-                     ->resolveEntry(m_parent->metaEntryBase(), QString("logos/%1").arg(logo.section(".", 0, 0)))
-                     ->getFullPath());
+        auto path = QString("logos/%1").arg(logo.section(".", 0, 0));
+        APPLICATION->metacache()->resolveEntryAsync(m_parent->metaEntryBase(), path, QString(), this,
+                                                    [callback](MetaEntryPtr entry) { callback(entry->getFullPath()); });
     } else {
         requestLogo(logo, logoUrl);
     }
@@ -150,27 +150,29 @@ void ListModel::requestLogo(QString logo, QString url)
         return;
     }
 
-    MetaEntryPtr entry =
-        APPLICATION->metacache()->resolveEntry(m_parent->metaEntryBase(), QString("logos/%1").arg(logo.section(".", 0, 0)));
-    auto job = new NetJob(QString("%1 Icon Download %2").arg(m_parent->debugName()).arg(logo), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath, job] {
-        job->deleteLater();
-        emit logoLoaded(logo, QIcon(fullPath));
-        if (waitingCallbacks.contains(logo)) {
-            waitingCallbacks.value(logo)(fullPath);
-        }
-    });
+    m_loadingLogos.append(logo);
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    auto path = QString("logos/%1").arg(logo.section(".", 0, 0));
+    APPLICATION->metacache()->resolveEntryAsync(m_parent->metaEntryBase(), path, QString(), this, [this, logo, url](MetaEntryPtr entry) {
+        auto job = new NetJob(QString("%1 Icon Download %2").arg(m_parent->debugName()).arg(logo), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
+
+        auto fullPath = entry->getFullPath();
+        QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath, job] {
+            job->deleteLater();
+            emit logoLoaded(logo, QIcon(fullPath));
+            if (waitingCallbacks.contains(logo)) {
+                waitingCallbacks.value(logo)(fullPath);
+            }
+        });
 
-    QObject::connect(job, &NetJob::failed, this, [this, logo, job] {
-        job->deleteLater();
-        emit logoFailed(logo);
-    });
+        QObject::connect(job, &NetJob::failed, this, [this, logo, job] {
+            job->deleteLater();
+            emit logoFailed(logo);
+        });
 
-    job->start();
-    m_loadingLogos.append(logo);
+        job->start();
+    });
 }
 
 /******** Request callbacks ********/
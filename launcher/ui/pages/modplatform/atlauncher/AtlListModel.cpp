@@ -149,7 +149,10 @@ void ListModel::getLogo(const QString &logo, const QString &logoUrl, LogoCallbac
 {
     if(m_logoMap.contains(logo))
     {
-        callback(APPLICATION->metacache()->resolveEntry("ATLauncherPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        APPLICATION->metacache()->resolveEntryAsync("ATLauncherPacks", QString("logos/%1").arg(logo.section(".", 0, 0)), QString(), this, [callback](MetaEntryPtr entry)
+        {
+            callback(entry->getFullPath());
+        });
     }
     else
     {
@@ -182,28 +185,30 @@ void ListModel::requestLogo(QString file, QString url)
         return;
     }
 
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", QString("logos/%1").arg(file.section(".", 0, 0)));
-    NetJob *job = new NetJob(QString("ATLauncher Icon Download %1").arg(file), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::succeeded, this, [this, file, fullPath]
+    m_loadingLogos.append(file);
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    APPLICATION->metacache()->resolveEntryAsync("ATLauncherPacks", QString("logos/%1").arg(file.section(".", 0, 0)), QString(), this, [this, file, url](MetaEntryPtr entry)
     {
-        emit logoLoaded(file, QIcon(fullPath));
-        if(waitingCallbacks.contains(file))
+        NetJob *job = new NetJob(QString("ATLauncher Icon Download %1").arg(file), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
+
+        auto fullPath = entry->getFullPath();
+        QObject::connect(job, &NetJob::succeeded, this, [this, file, fullPath]
         {
-            waitingCallbacks.value(file)(fullPath);
-        }
-    });
+            emit logoLoaded(file, QIcon(fullPath));
+            if(waitingCallbacks.contains(file))
+            {
+                waitingCallbacks.value(file)(fullPath);
+            }
+        });
+
+        QObject::connect(job, &NetJob::failed, this, [this, file]
+        {
+            emit logoFailed(file);
+        });
 
-    QObject::connect(job, &NetJob::failed, this, [this, file]
-    {
-        emit logoFailed(file);
+        job->start();
     });
-
-    job->start();
-
-    m_loadingLogos.append(file);
 }
 
 }
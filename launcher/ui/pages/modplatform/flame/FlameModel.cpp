@@ -91,33 +91,37 @@ void ListModel::requestLogo(QString logo, QString url)
         return;
     }
 
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo.section(".", 0, 0)));
-    auto job = new NetJob(QString("Flame Icon Download %1").arg(logo), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath, job] {
-        job->deleteLater();
-        emit logoLoaded(logo, QIcon(fullPath));
-        if (waitingCallbacks.contains(logo)) {
-            waitingCallbacks.value(logo)(fullPath);
-        }
-    });
-
-    QObject::connect(job, &NetJob::failed, this, [this, logo, job] {
-        job->deleteLater();
-        emit logoFailed(logo);
-    });
-
-    job->start();
-
     m_loadingLogos.append(logo);
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    auto path = QString("logos/%1").arg(logo.section(".", 0, 0));
+    APPLICATION->metacache()->resolveEntryAsync("FlamePacks", path, QString(), this, [this, logo, url](MetaEntryPtr entry) {
+        auto job = new NetJob(QString("Flame Icon Download %1").arg(logo), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
+
+        auto fullPath = entry->getFullPath();
+        QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath, job] {
+            job->deleteLater();
+            emit logoLoaded(logo, QIcon(fullPath));
+            if (waitingCallbacks.contains(logo)) {
+                waitingCallbacks.value(logo)(fullPath);
+            }
+        });
+
+        QObject::connect(job, &NetJob::failed, this, [this, logo, job] {
+            job->deleteLater();
+            emit logoFailed(logo);
+        });
+
+        job->start();
+    });
 }
 
 void ListModel::getLogo(const QString& logo, const QString& logoUrl, LogoCallback callback)
 {
     if (m_logoMap.contains(logo)) {
-        callback(APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        auto path = QString("logos/%1").arg(logo.section(".", 0, 0));
+        APPLICATION->metacache()->resolveEntryAsync("FlamePacks", path, QString(), this,
+                                                    [callback](MetaEntryPtr entry) { callback(entry->getFullPath()); });
     } else {
         requestLogo(logo, logoUrl);
     }
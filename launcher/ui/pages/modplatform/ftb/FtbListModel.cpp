@@ -93,7 +93,10 @@ void ListModel::getLogo(const QString &logo, const QString &logoUrl, LogoCallbac
 {
     if(m_logoMap.contains(logo))
     {
-        callback(APPLICATION->metacache()->resolveEntry("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        APPLICATION->metacache()->resolveEntryAsync("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)), QString(), this, [callback](MetaEntryPtr entry)
+        {
+            callback(entry->getFullPath());
+        });
     }
     else
     {
@@ -266,28 +269,32 @@ void ListModel::requestLogo(QString logo, QString url)
         return;
     }
 
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)));
+    // there's nothing to show until the entry is filled in, but it's there so we don't ask again
+    m_logoMap[logo];
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    APPLICATION->metacache()->resolveEntryAsync("ModpacksCHPacks", QString("logos/%1").arg(logo.section(".", 0, 0)), QString(), this, [this, logo, url](MetaEntryPtr entry)
+    {
+        bool stale = entry->isStale();
 
-    bool stale = entry->isStale();
+        NetJob *job = new NetJob(QString("ModpacksCH Icon Download %1").arg(logo), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
 
-    NetJob *job = new NetJob(QString("ModpacksCH Icon Download %1").arg(logo), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
+        auto fullPath = entry->getFullPath();
+        QObject::connect(job, &NetJob::finished, this, [this, logo, fullPath, stale]
+        {
+            logoLoaded(logo, stale);
+        });
 
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::finished, this, [this, logo, fullPath, stale]
-    {
-        logoLoaded(logo, stale);
-    });
+        QObject::connect(job, &NetJob::failed, this, [this, logo]
+        {
+            logoFailed(logo);
+        });
 
-    QObject::connect(job, &NetJob::failed, this, [this, logo]
-    {
-        logoFailed(logo);
+        auto &newLogoEntry = m_logoMap[logo];
+        newLogoEntry.downloadJob = job;
+        newLogoEntry.fullpath = fullPath;
+        job->start();
     });
-
-    auto &newLogoEntry = m_logoMap[logo];
-    newLogoEntry.downloadJob = job;
-    newLogoEntry.fullpath = fullPath;
-    job->start();
 }
 
 }
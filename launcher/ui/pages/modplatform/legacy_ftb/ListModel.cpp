@@ -250,35 +250,40 @@ void ListModel::requestLogo(QString file)
         return;
     }
 
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FTBPacks", QString("logos/%1").arg(file.section(".", 0, 0)));
-    NetJob *job = new NetJob(QString("FTB Icon Download for %1").arg(file), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/%1").arg(file)), entry));
-
-    auto fullPath = entry->getFullPath();
-    QObject::connect(job, &NetJob::finished, this, [this, file, fullPath]
+    m_loadingLogos.append(file);
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    APPLICATION->metacache()->resolveEntryAsync("FTBPacks", QString("logos/%1").arg(file.section(".", 0, 0)), QString(), this, [this, file](MetaEntryPtr entry)
     {
-        emit logoLoaded(file, QIcon(fullPath));
-        if(waitingCallbacks.contains(file))
+        NetJob *job = new NetJob(QString("FTB Icon Download for %1").arg(file), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/%1").arg(file)), entry));
+
+        auto fullPath = entry->getFullPath();
+        QObject::connect(job, &NetJob::finished, this, [this, file, fullPath]
         {
-            waitingCallbacks.value(file)(fullPath);
-        }
-    });
+            emit logoLoaded(file, QIcon(fullPath));
+            if(waitingCallbacks.contains(file))
+            {
+                waitingCallbacks.value(file)(fullPath);
+            }
+        });
+
+        QObject::connect(job, &NetJob::failed, this, [this, file]
+        {
+            emit logoFailed(file);
+        });
 
-    QObject::connect(job, &NetJob::failed, this, [this, file]
-    {
-        emit logoFailed(file);
+        job->start();
     });
-
-    job->start();
-
-    m_loadingLogos.append(file);
 }
 
 void ListModel::getLogo(const QString &logo, LogoCallback callback)
 {
     if(m_logoMap.contains(logo))
     {
-        callback(APPLICATION->metacache()->resolveEntry("FTBPacks", QString("logos/%1").arg(logo.section(".", 0, 0)))->getFullPath());
+        APPLICATION->metacache()->resolveEntryAsync("FTBPacks", QString("logos/%1").arg(logo.section(".", 0, 0)), QString(), this, [callback](MetaEntryPtr entry)
+        {
+            callback(entry->getFullPath());
+        });
     }
     else
     {
@@ -231,7 +231,10 @@ void Technic::ListModel::getLogo(const QString& logo, const QString& logoUrl, Te
 {
     if(m_logoMap.contains(logo))
     {
-        callback(APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("logos/%1").arg(logo))->getFullPath());
+        APPLICATION->metacache()->resolveEntryAsync("TechnicPacks", QString("logos/%1").arg(logo), QString(), this, [callback](MetaEntryPtr entry)
+        {
+            callback(entry->getFullPath());
+        });
     }
     else
     {
@@ -284,23 +287,25 @@ void Technic::ListModel::requestLogo(QString logo, QString url)
         return;
     }
 
-    MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("logos/%1").arg(logo));
-    NetJob *job = new NetJob(QString("Technic Icon Download %1").arg(logo), APPLICATION->network());
-    job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
-
-    auto fullPath = entry->getFullPath();
-
-    QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath]
+    m_loadingLogos.append(logo);
+    // checking the cached logo can take hashing it, which is kept off the GUI thread
+    APPLICATION->metacache()->resolveEntryAsync("TechnicPacks", QString("logos/%1").arg(logo), QString(), this, [this, logo, url](MetaEntryPtr entry)
     {
-        logoLoaded(logo, fullPath);
-    });
+        NetJob *job = new NetJob(QString("Technic Icon Download %1").arg(logo), APPLICATION->network());
+        job->addNetAction(Net::Download::makeCached(QUrl(url), entry));
 
-    QObject::connect(job, &NetJob::failed, this, [this, logo]
-    {
-        logoFailed(logo);
-    });
+        auto fullPath = entry->getFullPath();
 
-    job->start();
+        QObject::connect(job, &NetJob::succeeded, this, [this, logo, fullPath]
+        {
+            logoLoaded(logo, fullPath);
+        });
 
-    m_loadingLogos.append(logo);
+        QObject::connect(job, &NetJob::failed, this, [this, logo]
+        {
+            logoFailed(logo);
+        });
+
+        job->start();
+    });
 }
@@ -37,10 +37,18 @@
 #include <QTextBlock>
 #include <QScrollBar>
 
+#include <algorithm>
+
+// how many rows are paged in at once when scrolling past the window
+static const int s_page_rows = 1000;
+
 LogView::LogView(QWidget* parent) : QPlainTextEdit(parent)
 {
     setWordWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    // nobody is going to undo the game's output, don't keep every inserted line around for it
+    setUndoRedoEnabled(false);
     m_defaultFormat = new QTextCharFormat(currentCharFormat());
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &LogView::scrolled);
 }
 
 LogView::~LogView()
@@ -96,40 +104,68 @@ void LogView::modelDestroyed(QObject* model)
     }
 }
 
+int LogView::maxRows() const
+{
+    return m_maxRows;
+}
+
+void LogView::setMaxRows(int rows)
+{
+    m_maxRows = std::max(rows, 2 * s_page_rows);
+    repopulate();
+}
+
+void LogView::setFollowing(bool following)
+{
+    m_following = following;
+}
+
+int LogView::currentRow() const
+{
+    return m_firstRow + textCursor().blockNumber();
+}
+
+bool LogView::atEnd() const
+{
+    return m_model && m_firstRow + m_rows >= m_model->rowCount();
+}
+
 void LogView::repopulate()
 {
-    auto doc = document();
-    doc->clear();
     if(!m_model)
     {
+        document()->clear();
+        m_firstRow = 0;
+        m_rows = 0;
         return;
     }
-    rowsInserted(QModelIndex(), 0, m_model->rowCount() - 1);
+    int count = m_model->rowCount();
+    loadWindow(std::max(0, count - m_maxRows), count - 1);
 }
 
-void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
+void LogView::loadWindow(int first, int last)
 {
-    Q_UNUSED(parent)
-    Q_UNUSED(first)
-    Q_UNUSED(last)
-    QScrollBar *bar = verticalScrollBar();
-    int max_bar = bar->maximum();
-    int val_bar = bar->value();
-    if (m_scroll)
-    {
-        m_scroll = (max_bar - val_bar) <= 1;
-    }
-    else
-    {
-        m_scroll = val_bar == max_bar;
-    }
+    m_paging = true;
+    document()->clear();
+    m_firstRow = first;
+    m_rows = 0;
+    auto workCursor = textCursor();
+    workCursor.movePosition(QTextCursor::End);
+    insertRows(workCursor, first, last);
+    m_paging = false;
 }
 
-void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
+void LogView::insertRows(QTextCursor& cursor, int first, int last)
 {
+    if(first > last)
+    {
+        return;
+    }
+    // lay the document out once for all the new lines, not once per line
+    cursor.beginEditBlock();
     for(int i = first; i <= last; i++)
     {
-        auto idx = m_model->index(i, 0, parent);
+        auto idx = m_model->index(i, 0);
         auto text = m_model->data(idx, Qt::DisplayRole).toString();
         QTextCharFormat format(*m_defaultFormat);
         auto font = m_model->data(idx, Qt::FontRole);
@@ -147,10 +183,91 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
         {
             format.setBackground(bg.value<QColor>());
         }
-        auto workCursor = textCursor();
-        workCursor.movePosition(QTextCursor::End);
-        workCursor.insertText(text, format);
-        workCursor.insertBlock();
+        cursor.insertText(text, format);
+        cursor.insertBlock();
+    }
+    cursor.endEditBlock();
+    m_rows += last - first + 1;
+}
+
+void LogView::dropRows(int count, bool fromTop)
+{
+    count = std::min(count, m_rows);
+    if(count <= 0)
+    {
+        return;
+    }
+    m_paging = true;
+    auto bar = verticalScrollBar();
+    int value = bar->value();
+    // the scroll bar counts lines, which aren't blocks when wrapping
+    int droppedLines = document()->findBlockByNumber(count).firstLineNumber();
+
+    QTextCursor cursor(document());
+    if(fromTop)
+    {
+        cursor.movePosition(QTextCursor::Start);
+        cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, count);
+        m_firstRow += count;
+    }
+    else
+    {
+        cursor.movePosition(QTextCursor::End);
+        cursor.movePosition(QTextCursor::PreviousBlock, QTextCursor::KeepAnchor, count);
+        cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+    }
+    cursor.removeSelectedText();
+    m_rows -= count;
+
+    if(fromTop)
+    {
+        bar->setValue(std::max(0, value - droppedLines));
+    }
+    m_paging = false;
+}
+
+void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    Q_UNUSED(first)
+    Q_UNUSED(last)
+    QScrollBar *bar = verticalScrollBar();
+    int max_bar = bar->maximum();
+    int val_bar = bar->value();
+    if (m_scroll)
+    {
+        m_scroll = (max_bar - val_bar) <= 1;
+    }
+    else
+    {
+        m_scroll = val_bar == max_bar;
+    }
+    // only follow the log if we're showing the end of it
+    m_scroll = m_scroll && atEnd() && m_following;
+}
+
+void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(parent)
+    // somewhere back in the log, the new rows get paged in when scrolling down to them
+    if(m_firstRow + m_rows != first)
+    {
+        return;
+    }
+    if(!m_following)
+    {
+        last = std::min(last, first + m_maxRows - m_rows - 1);
+        if(last < first)
+        {
+            return;
+        }
+    }
+    auto workCursor = textCursor();
+    workCursor.movePosition(QTextCursor::End);
+    insertRows(workCursor, first, last);
+    if(m_rows > m_maxRows)
+    {
+        dropRows(m_rows - m_maxRows, true);
     }
     if(m_scroll && !m_scrolling)
     {
@@ -161,18 +278,96 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 
 void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
 {
-    // TODO: some day... maybe
     Q_UNUSED(parent)
     Q_UNUSED(first)
-    Q_UNUSED(last)
+    // the text of the removed rows stays until it's scrolled out, only the rows after them move up
+    m_firstRow -= last - first + 1;
+}
+
+void LogView::scrolled(int value)
+{
+    if(m_paging || !m_model)
+    {
+        return;
+    }
+    auto bar = verticalScrollBar();
+    if(value == bar->minimum() && m_firstRow > 0)
+    {
+        int first = std::max(0, m_firstRow - s_page_rows);
+        int count = m_firstRow - first;
+        m_paging = true;
+        QTextCursor cursor(document());
+        cursor.movePosition(QTextCursor::Start);
+        m_firstRow = first;
+        insertRows(cursor, first, first + count - 1);
+        // keep the rows that were on screen there
+        bar->setValue(document()->findBlockByNumber(count).firstLineNumber());
+        m_paging = false;
+        if(m_rows > m_maxRows)
+        {
+            dropRows(m_rows - m_maxRows, false);
+        }
+    }
+    else if(value == bar->maximum() && !atEnd())
+    {
+        int first = m_firstRow + m_rows;
+        int last = std::min(m_model->rowCount(), first + s_page_rows) - 1;
+        m_paging = true;
+        QTextCursor cursor(document());
+        cursor.movePosition(QTextCursor::End);
+        insertRows(cursor, first, last);
+        m_paging = false;
+        if(m_rows > m_maxRows)
+        {
+            dropRows(m_rows - m_maxRows, true);
+        }
+    }
+}
+
+void LogView::showRow(int row, const QString& what)
+{
+    if(!m_model || row < 0 || row >= m_model->rowCount())
+    {
+        return;
+    }
+    if(row < m_firstRow || row >= m_firstRow + m_rows)
+    {
+        int count = m_model->rowCount();
+        int first = std::max(0, std::min(row - m_maxRows / 2, count - m_maxRows));
+        loadWindow(first, std::min(count, first + m_maxRows) - 1);
+    }
+    auto block = document()->findBlockByNumber(row - m_firstRow);
+    QTextCursor cursor(block);
+    int pos = block.text().indexOf(what, 0, Qt::CaseInsensitive);
+    if(pos >= 0)
+    {
+        cursor.setPosition(block.position() + pos);
+        cursor.setPosition(block.position() + pos + what.size(), QTextCursor::KeepAnchor);
+    }
+    setTextCursor(cursor);
+    centerCursor();
 }
 
 void LogView::scrollToBottom()
 {
     m_scrolling = false;
+    if(!atEnd())
+    {
+        repopulate();
+    }
     verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
 }
 
+void LogView::scrollToTop()
+{
+    if(m_model && m_firstRow > 0)
+    {
+        loadWindow(0, std::min(m_model->rowCount(), m_maxRows) - 1);
+    }
+    moveCursor(QTextCursor::Start);
+    verticalScrollBar()->setSliderPosition(verticalScrollBar()->minimum());
+}
+
 void LogView::findNext(const QString& what, bool reverse)
 {
     find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
@@ -4,6 +4,13 @@
 
 class QAbstractItemModel;
 
+/**
+ * Shows the rows of a log model as text.
+ *
+ * Only a window of up to maxRows() rows is kept in the document, which follows the end of the log while scrolled to
+ * the bottom. Scrolling to either end of the window pages in more rows from the model and drops as many from the other
+ * end, so the size of the model doesn't matter.
+ */
 class LogView: public QPlainTextEdit
 {
     Q_OBJECT
@@ -14,10 +21,23 @@ public:
     virtual void setModel(QAbstractItemModel *model);
     QAbstractItemModel *model() const;
 
+    int maxRows() const;
+    void setMaxRows(int rows);
+
+    /// The model row the text cursor is in
+    int currentRow() const;
+
+    /// Whether to keep showing the end of the log as rows come in while it's scrolled to the bottom (the default).
+    /// Without that, new rows only fill up the window and the rest is paged in when scrolling down to it.
+    void setFollowing(bool following);
+
 public slots:
     void setWordWrap(bool wrapping);
     void findNext(const QString & what, bool reverse);
+    /// Bring `row` into view and select the first `what` in it
+    void showRow(int row, const QString & what);
     void scrollToBottom();
+    void scrollToTop();
 
 protected slots:
     void repopulate();
@@ -27,10 +47,29 @@ protected slots:
     // note: this supports only removing from front
     void rowsRemoved(const QModelIndex &parent, int first, int last);
     void modelDestroyed(QObject * model);
+    void scrolled(int value);
+
+protected:
+    // show rows `first` to `last` of the model, starting with `first`
+    void loadWindow(int first, int last);
+    // add rows `first` to `last` of the model at the cursor
+    void insertRows(QTextCursor & cursor, int first, int last);
+    // drop `count` rows from the top or the bottom of the window, keeping what's on screen where it is
+    void dropRows(int count, bool fromTop);
+    // the window ends with the last row of the model
+    bool atEnd() const;
 
 protected:
     QAbstractItemModel *m_model = nullptr;
     QTextCharFormat *m_defaultFormat = nullptr;
+    bool m_following = true;
     bool m_scroll = false;
     bool m_scrolling = false;
+
+    int m_maxRows = 10000;
+    // the model row of the first block, and how many rows there are in the document
+    int m_firstRow = 0;
+    int m_rows = 0;
+    // set while we change the window ourselves, so it doesn't look like the user scrolling
+    bool m_paging = false;
 };
@@ -8,6 +8,14 @@
 
 #include "MurmurHash2.h"
 
+#include <bitset>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MURMUR2_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 //-----------------------------------------------------------------------------
 
 // 'm' and 'r' are mixing constants generated offline.
@@ -68,6 +76,114 @@ uint32_t MurmurHash2(std::ifstream&& file_stream, std::size_t buffer_size, std::
     return info.h;
 }
 
+static inline bool IsCurseForgeWhitespace(unsigned char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+#ifdef MURMUR2_USE_SSE2
+// Bit i is set if byte i of the 16 byte block is whitespace
+static inline uint32_t WhitespaceMask(const unsigned char* block)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i tab_lf = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(9)), _mm_cmpeq_epi8(v, _mm_set1_epi8(10)));
+    __m128i cr_space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(13)), _mm_cmpeq_epi8(v, _mm_set1_epi8(32)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(tab_lf, cr_space)));
+}
+#else
+static inline uint32_t WhitespaceMask(const unsigned char* block)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; i++)
+        mask |= uint32_t(IsCurseForgeWhitespace(block[i])) << i;
+    return mask;
+}
+#endif
+
+// Copy what isn't whitespace out of a 16 byte block, returns how many bytes were kept
+static inline std::size_t CompactBlock(const unsigned char* block, uint32_t mask, unsigned char* out)
+{
+    if (mask == 0) {
+        memcpy(out, block, 16);
+        return 16;
+    }
+    // always write, only move on for the bytes we keep
+    std::size_t kept = 0;
+    for (int i = 0; i < 16; i++) {
+        out[kept] = block[i];
+        kept += ((mask >> i) & 1) ^ 1;
+    }
+    return kept;
+}
+
+static inline uint32_t Mix(uint32_t h, uint32_t k)
+{
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h *= m;
+    h ^= k;
+    return h;
+}
+
+uint32_t CurseForgeFingerprint(const unsigned char* data, std::size_t size)
+{
+    const std::size_t blocks_end = size & ~std::size_t(15);
+
+    // The seed depends on the filtered size, so count first. This only touches memory, not the disk.
+    uint32_t length = 0;
+    for (std::size_t i = 0; i < blocks_end; i += 16)
+        length += 16 - uint32_t(std::bitset<16>(WhitespaceMask(data + i)).count());
+    for (std::size_t i = blocks_end; i < size; i++)
+        length += !IsCurseForgeWhitespace(data[i]);
+
+    // This forces a seed of 1.
+    uint32_t h = 1 ^ length;
+
+    // Compact into a small buffer that stays in cache, and hash 4 bytes at a time out of it
+    unsigned char stage[4096 + 16];
+    std::size_t staged = 0;
+    auto mix_staged = [&] {
+        std::size_t words_end = staged & ~std::size_t(3);
+        for (std::size_t i = 0; i < words_end; i += 4) {
+            uint32_t k;
+            memcpy(&k, stage + i, 4);
+            h = Mix(h, k);
+        }
+        memmove(stage, stage + words_end, staged - words_end);
+        staged -= words_end;
+    };
+
+    for (std::size_t i = 0; i < blocks_end; i += 16) {
+        staged += CompactBlock(data + i, WhitespaceMask(data + i), stage + staged);
+        if (staged >= 4096)
+            mix_staged();
+    }
+    for (std::size_t i = blocks_end; i < size; i++) {
+        stage[staged] = data[i];
+        staged += !IsCurseForgeWhitespace(data[i]);
+    }
+    mix_staged();
+
+    // Handle the last few bytes, and do a few final mixes
+    switch (staged) {
+        case 3:
+            h ^= stage[2] << 16;
+        case 2:
+            h ^= stage[1] << 8;
+        case 1:
+            h ^= stage[0];
+            h *= m;
+    };
+
+    h ^= h >> 13;
+    h *= m;
+    h ^= h >> 15;
+
+    return h;
+}
+
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
 {
     if (prev.len >= 4) {